@@ -0,0 +1,160 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Build-time helper: rasterizes symbolic icons from an icon theme into a single
+ * alpha-mask atlas, which is compiled into iwgtk as a GResource.
+ *
+ * Usage: icon-atlas THEME_DIR SIZE OUTPUT ICON_NAME...
+ *
+ * The output is a little-endian serialized GVariant of type (qqa{s(qqqq)}ay): the
+ * atlas width and height, a map from icon name to (x, y, width, height), and the
+ * 8-bit alpha values of the atlas in row-major order.
+ */
+
+#include <stdlib.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#define ATLAS_TYPE "(qqa{s(qqqq)}ay)"
+
+static GdkPixbuf* icon_load(const gchar *theme_dir, const gchar *icon_name, int size) {
+    static const gchar *subdirs[] = {"symbolic/status", "scalable/status", NULL};
+    gchar *filename;
+    GdkPixbuf *pixbuf;
+
+    filename = g_strconcat(icon_name, ".svg", NULL);
+    pixbuf = NULL;
+
+    for (int i = 0; subdirs[i] != NULL && pixbuf == NULL; i ++) {
+	gchar *path;
+	GError *err;
+
+	path = g_build_filename(theme_dir, subdirs[i], filename, NULL);
+
+	if (g_file_test(path, G_FILE_TEST_IS_REGULAR)) {
+	    err = NULL;
+	    pixbuf = gdk_pixbuf_new_from_file_at_size(path, size, size, &err);
+
+	    if (pixbuf == NULL) {
+		g_printerr("Failed to load %s: %s\n", path, err->message);
+		g_error_free(err);
+	    }
+	}
+
+	g_free(path);
+    }
+
+    g_free(filename);
+    return pixbuf;
+}
+
+int main(int argc, char **argv) {
+    const gchar *theme_dir, *output;
+    int size, n_icons;
+    guint8 *alpha;
+    guint16 atlas_width, atlas_height;
+    GVariantBuilder entries;
+
+    if (argc < 5) {
+	g_printerr("Usage: %s THEME_DIR SIZE OUTPUT ICON_NAME...\n", argv[0]);
+	return EXIT_FAILURE;
+    }
+
+    theme_dir = argv[1];
+    size = atoi(argv[2]);
+    output = argv[3];
+    n_icons = argc - 4;
+
+    if (size <= 0 || size*n_icons > G_MAXUINT16) {
+	g_printerr("Invalid icon size: %s\n", argv[2]);
+	return EXIT_FAILURE;
+    }
+
+    /*
+     * The icons are laid out in a single row.
+     */
+    atlas_width = size*n_icons;
+    atlas_height = size;
+    alpha = g_malloc0(atlas_width*atlas_height);
+
+    g_variant_builder_init(&entries, G_VARIANT_TYPE("a{s(qqqq)}"));
+
+    for (int i = 0; i < n_icons; i ++) {
+	GdkPixbuf *pixbuf;
+	const guchar *pixels;
+	int width, height, rowstride, n_channels, x0, y0;
+
+	pixbuf = icon_load(theme_dir, argv[4 + i], size);
+
+	if (pixbuf == NULL) {
+	    g_printerr("Icon '%s' not found in %s\n", argv[4 + i], theme_dir);
+	    return EXIT_FAILURE;
+	}
+
+	width = MIN(gdk_pixbuf_get_width(pixbuf), size);
+	height = MIN(gdk_pixbuf_get_height(pixbuf), size);
+	rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+	n_channels = gdk_pixbuf_get_n_channels(pixbuf);
+	pixels = gdk_pixbuf_read_pixels(pixbuf);
+
+	x0 = i*size + (size - width)/2;
+	y0 = (size - height)/2;
+
+	for (int y = 0; y < height; y ++) {
+	    for (int x = 0; x < width; x ++) {
+		alpha[(y0 + y)*atlas_width + x0 + x] = gdk_pixbuf_get_has_alpha(pixbuf) ? pixels[y*rowstride + x*n_channels + 3] : 0xff;
+	    }
+	}
+
+	g_variant_builder_add(&entries, "{s(qqqq)}", argv[4 + i], (guint16) (i*size), (guint16) 0, (guint16) size, (guint16) size);
+	g_object_unref(pixbuf);
+    }
+
+    {
+	GVariant *atlas;
+	GError *err;
+
+	atlas = g_variant_new(ATLAS_TYPE,
+	    atlas_width,
+	    atlas_height,
+	    &entries,
+	    g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, alpha, atlas_width*atlas_height, 1));
+	g_variant_ref_sink(atlas);
+
+	if (G_BYTE_ORDER == G_BIG_ENDIAN) {
+	    GVariant *swapped;
+
+	    swapped = g_variant_byteswap(atlas);
+	    g_variant_unref(atlas);
+	    atlas = swapped;
+	}
+
+	err = NULL;
+	if (!g_file_set_contents(output, g_variant_get_data(atlas), g_variant_get_size(atlas), &err)) {
+	    g_printerr("Failed to write %s: %s\n", output, err->message);
+	    g_error_free(err);
+	    return EXIT_FAILURE;
+	}
+
+	g_variant_unref(atlas);
+    }
+
+    g_free(alpha);
+    return EXIT_SUCCESS;
+}
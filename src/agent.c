@@ -95,7 +95,7 @@ void agent_register(GDBusProxy *proxy) {
     agent->window = NULL;
 
     err = NULL;
-    agent->registration_id = g_dbus_connection_register_object(
+    agent->registration_id = worker_register_object(
 	    g_dbus_proxy_get_connection(proxy),
 	    IWGTK_PATH_AGENT,
 	    &agent_interface_info,
@@ -120,51 +120,96 @@ void agent_register(GDBusProxy *proxy) {
 	(gpointer) agent_error_msg);
 }
 
+/*
+ * Called on the worker thread once the agent object has been unregistered.
+ */
 void agent_remove(Agent *agent) {
+    g_main_context_invoke(NULL, (GSourceFunc) agent_free, agent);
+}
+
+gboolean agent_free(Agent *agent) {
     if (agent->window) {
 	gtk_window_destroy(GTK_WINDOW(agent->window));
     }
 
     g_free(agent);
+    return G_SOURCE_REMOVE;
 }
 
+/*
+ * Runs on the worker thread. Release and Cancel are answered immediately; only the
+ * credential prompt, which has to wait for the user, keeps its invocation open.
+ */
 void agent_method_call_handler(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *params, GDBusMethodInvocation *invocation, Agent *agent) {
-    if (agent->window) {
-	gtk_window_destroy(GTK_WINDOW(agent->window));
-    }
+    AgentRequest *request;
 
-    agent->invocation = invocation;
+    request = g_malloc(sizeof(AgentRequest));
+    request->agent = agent;
+    request->invocation = invocation;
+    request->method_name = NULL;
+    request->request_type = USERNAME_NONE;
+    request->reason = NULL;
 
     if (strcmp(method_name, "Release") == 0) {
+	request->method_name = "Release";
+	request->invocation = NULL;
 	g_dbus_method_invocation_return_value(invocation, NULL);
 	g_dbus_connection_unregister_object(connection, agent->registration_id);
     }
     else if (strcmp(method_name, "RequestPassphrase") == 0) {
-	request_dialog(agent, USERNAME_NONE);
+	request->method_name = "RequestPassphrase";
     }
     else if (strcmp(method_name, "RequestPrivateKeyPassphrase") == 0) {
-	request_dialog(agent, USERNAME_NONE);
+	request->method_name = "RequestPrivateKeyPassphrase";
     }
     else if (strcmp(method_name, "RequestUserNameAndPassword") == 0) {
-	request_dialog(agent, USERNAME_ASK);
+	request->method_name = "RequestUserNameAndPassword";
+	request->request_type = USERNAME_ASK;
     }
     else if (strcmp(method_name, "RequestUserPassword") == 0) {
-	request_dialog(agent, USERNAME_TELL);
+	request->method_name = "RequestUserPassword";
+	request->request_type = USERNAME_TELL;
     }
     else if (strcmp(method_name, "Cancel") == 0) {
-	const gchar *reason;
-	gchar *message;
-
-	g_variant_get(params, "(&s)", &reason);
-	message = g_strdup_printf(_("Connection attempt has been canceled: %s"), reason);
-	send_notification(message);
-	g_free(message);
-
+	request->method_name = "Cancel";
+	request->invocation = NULL;
+	g_variant_get(params, "(s)", &request->reason);
 	g_dbus_method_invocation_return_value(invocation, NULL);
     }
     else {
 	g_dbus_method_invocation_return_dbus_error(invocation, "org.freedesktop.DBus.Error.UnknownMethod", "Unknown method");
+	g_free(request);
+	return;
+    }
+
+    g_main_context_invoke(NULL, (GSourceFunc) agent_request_dispatch, request);
+}
+
+gboolean agent_request_dispatch(AgentRequest *request) {
+    Agent *agent;
+
+    agent = request->agent;
+    watchdog_mark("Agent.%s", request->method_name);
+
+    if (agent->window) {
+	gtk_window_destroy(GTK_WINDOW(agent->window));
+    }
+
+    if (request->invocation) {
+	agent->invocation = request->invocation;
+	request_dialog(agent, request->request_type);
     }
+    else if (request->reason) {
+	gchar *message;
+
+	message = g_strdup_printf(_("Connection attempt has been canceled: %s"), request->reason);
+	send_notification(message);
+	g_free(message);
+    }
+
+    g_free(request->reason);
+    g_free(request);
+    return G_SOURCE_REMOVE;
 }
 
 void request_dialog(Agent *agent, guint8 request_type) {
@@ -202,20 +247,44 @@ void request_dialog(Agent *agent, guint8 request_type) {
 	    agent->user_widget = NULL;
     }
 
+    connect_latency_prompt_begin(network_path);
+
     {
+	GtkWidget *ssid_label;
 	GDBusProxy *proxy;
-	GVariant *ssid_var;
-	const gchar *ssid;
-
-	proxy = G_DBUS_PROXY(g_dbus_object_manager_get_interface(global.manager, network_path, IWD_IFACE_NETWORK));
-	ssid_var = g_dbus_proxy_get_cached_property(proxy, "Name");
-	ssid = g_variant_get_string(ssid_var, NULL);
 
+	ssid_label = gtk_label_new(NULL);
 	gtk_grid_attach(GTK_GRID(table), gtk_label_new(_("SSID: ")), 0, 0, 1, 1);
-	gtk_grid_attach(GTK_GRID(table), gtk_label_new(ssid),        1, 0, 1, 1);
+	gtk_grid_attach(GTK_GRID(table), ssid_label,                 1, 0, 1, 1);
+
+	/*
+	 * Without a window, there is no object manager which caches networks, so
+	 * the SSID is fetched on demand.
+	 */
+	proxy = NULL;
+	if (global.manager) {
+	    proxy = G_DBUS_PROXY(g_dbus_object_manager_get_interface(global.manager, network_path, IWD_IFACE_NETWORK));
+	}
 
-	g_variant_unref(ssid_var);
-	g_object_unref(proxy);
+	if (proxy) {
+	    GVariant *ssid_var;
+
+	    ssid_var = g_dbus_proxy_get_cached_property(proxy, "Name");
+	    gtk_label_set_text(GTK_LABEL(ssid_label), g_variant_get_string(ssid_var, NULL));
+
+	    g_variant_unref(ssid_var);
+	    g_object_unref(proxy);
+	}
+	else {
+	    remote_property_get(
+		g_dbus_method_invocation_get_connection(agent->invocation),
+		network_path,
+		IWD_IFACE_NETWORK,
+		"Name",
+		NULL,
+		(GAsyncReadyCallback) request_dialog_ssid_callback,
+		g_object_ref(ssid_label));
+	}
     }
 
     i = 1;
@@ -248,6 +317,25 @@ void request_dialog(Agent *agent, guint8 request_type) {
     gtk_widget_set_visible(agent->window, true);
 }
 
+void request_dialog_ssid_callback(GDBusConnection *connection, GAsyncResult *res, GtkWidget *ssid_label) {
+    GVariant *ssid_var;
+    GError *err;
+
+    err = NULL;
+    ssid_var = remote_property_get_finish(connection, res, &err);
+
+    if (ssid_var) {
+	gtk_label_set_text(GTK_LABEL(ssid_label), g_variant_get_string(ssid_var, NULL));
+	g_variant_unref(ssid_var);
+    }
+    else {
+	g_printerr("Failed to look up network name: %s\n", err->message);
+	g_error_free(err);
+    }
+
+    g_object_unref(ssid_label);
+}
+
 void request_submit(Agent *agent) {
     const gchar *password;
 
@@ -278,6 +366,7 @@ void request_submit(Agent *agent) {
 void agent_window_destroy(Agent *agent) {
     g_object_unref(agent->window);
     agent->window = NULL;
+    connect_latency_prompt_end();
 
     if (agent->invocation) {
 	g_dbus_method_invocation_return_dbus_error(agent->invocation, "net.connman.iwd.Agent.Error.Canceled", "Connection attempt canceled");
@@ -25,6 +25,7 @@
 #define USERNAME_TELL 2
 
 typedef struct Agent_s Agent;
+typedef struct AgentRequest_s AgentRequest;
 
 struct Agent_s {
     guint registration_id;
@@ -36,10 +37,25 @@ struct Agent_s {
     GtkWidget *pass_widget;
 };
 
+/*
+ * An agent method call, passed from the worker thread to the main thread. For
+ * Release and Cancel, iwd has already received its reply and invocation is NULL.
+ */
+struct AgentRequest_s {
+    Agent *agent;
+    GDBusMethodInvocation *invocation;
+    const gchar *method_name;
+    guint8 request_type;
+    gchar *reason;
+};
+
 void agent_register(GDBusProxy *proxy);
 void agent_remove(Agent *agent);
+gboolean agent_free(Agent *agent);
 void agent_method_call_handler(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *parameters, GDBusMethodInvocation *invocation, Agent *data);
+gboolean agent_request_dispatch(AgentRequest *request);
 void request_dialog(Agent *data, guint8 request_type);
+void request_dialog_ssid_callback(GDBusConnection *connection, GAsyncResult *res, GtkWidget *ssid_label);
 void request_submit(Agent *data);
 void agent_window_destroy(Agent *data);
 
@@ -0,0 +1,304 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+/*
+ * Count the clients in an AccessPointDiagnostic reply (aa{sv}), and add up their
+ * throughput in kbit/s. The expected throughput is used if iwd reports it;
+ * otherwise, the TX bitrate.
+ */
+void ap_diagnostic_aggregate(GVariant *clients, guint *n_clients, guint64 *throughput) {
+    GVariantIter iter;
+    GVariant *client;
+
+    *n_clients = 0;
+    *throughput = 0;
+
+    g_variant_iter_init(&iter, clients);
+
+    while ((client = g_variant_iter_next_value(&iter))) {
+	guint32 rate;
+
+	if (g_variant_lookup(client, "ExpectedThroughput", "u", &rate)) {
+	    *throughput += rate;
+	}
+	else if (g_variant_lookup(client, "TxBitrate", "u", &rate)) {
+	    *throughput += (guint64) rate * 100;
+	}
+
+	(*n_clients) ++;
+	g_variant_unref(client);
+    }
+}
+
+gchar* ap_diagnostic_summary(guint n_clients, guint64 throughput) {
+    gchar *clients_str, *summary;
+
+    clients_str = g_strdup_printf(ngettext("%u client", "%u clients", n_clients), n_clients);
+
+    if (n_clients == 0) {
+	return clients_str;
+    }
+
+    summary = g_strdup_printf(_("%s, %.1f Mbit/s"), clients_str, throughput / 1000.0);
+    g_free(clients_str);
+    return summary;
+}
+
+gboolean ap_diagnostic_poll(APDiagnostic *ap_diagnostic) {
+    if (ap_diagnostic->cancellable == NULL) {
+	ap_diagnostic->cancellable = g_cancellable_new();
+
+	g_dbus_proxy_call(
+	    ap_diagnostic->proxy,
+	    "GetDiagnostics",
+	    NULL,
+	    G_DBUS_CALL_FLAGS_NONE,
+	    -1,
+	    ap_diagnostic->cancellable,
+	    (GAsyncReadyCallback) ap_diagnostic_results_cb,
+	    ap_diagnostic);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+void ap_diagnostic_results_cb(GDBusProxy *proxy, GAsyncResult *res, APDiagnostic *ap_diagnostic) {
+    GVariant *ret;
+    GError *err;
+
+    watchdog_mark("AccessPointDiagnostic.GetDiagnostics reply");
+
+    err = NULL;
+    ret = g_dbus_proxy_call_finish(proxy, res, &err);
+
+    if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+	g_error_free(err);
+	return;
+    }
+
+    g_clear_object(&ap_diagnostic->cancellable);
+
+    if (ret) {
+	GVariant *clients;
+
+	clients = g_variant_get_child_value(ret, 0);
+	ap_diagnostic->generation ++;
+
+	{
+	    GVariantIter iter;
+	    GVariant *client;
+
+	    g_variant_iter_init(&iter, clients);
+
+	    while ((client = g_variant_iter_next_value(&iter))) {
+		ap_diagnostic_client_update(ap_diagnostic, client);
+		g_variant_unref(client);
+	    }
+	}
+
+	// Remove the clients which have left
+	{
+	    GHashTableIter iter;
+	    APClient *client;
+
+	    g_hash_table_iter_init(&iter, ap_diagnostic->clients);
+
+	    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &client)) {
+		if (client->generation != ap_diagnostic->generation) {
+		    int row;
+
+		    gtk_grid_query_child(GTK_GRID(ap_diagnostic->table), client->address_label, NULL, &row, NULL, NULL);
+		    gtk_grid_remove_row(GTK_GRID(ap_diagnostic->table), row);
+		    g_hash_table_iter_remove(&iter);
+		}
+	    }
+	}
+
+	{
+	    guint n_clients;
+	    guint64 throughput;
+	    gchar *summary;
+
+	    ap_diagnostic_aggregate(clients, &n_clients, &throughput);
+	    summary = ap_diagnostic_summary(n_clients, throughput);
+	    gtk_label_set_text(GTK_LABEL(ap_diagnostic->summary_label), summary);
+	    g_free(summary);
+
+	    gtk_widget_set_visible(ap_diagnostic->table, n_clients > 0);
+	}
+
+	g_variant_unref(clients);
+	g_variant_unref(ret);
+    }
+    else {
+	g_printerr("Failed to retrieve access point diagnostics: %s\n", err->message);
+	g_error_free(err);
+    }
+}
+
+static void label_text_update(GtkWidget *label, const gchar *text) {
+    if (g_strcmp0(gtk_label_get_text(GTK_LABEL(label)), text) != 0) {
+	gtk_label_set_text(GTK_LABEL(label), text);
+    }
+}
+
+static gchar* bitrate_format(GVariant *client, const gchar *key) {
+    guint32 bitrate;
+
+    // Bitrates are in units of 100 kbit/s
+    if (g_variant_lookup(client, key, "u", &bitrate)) {
+	return g_strdup_printf(_("%.1f Mbit/s"), bitrate / 10.0);
+    }
+
+    return g_strdup("");
+}
+
+void ap_diagnostic_client_update(APDiagnostic *ap_diagnostic, GVariant *client_var) {
+    APClient *client;
+    const gchar *address;
+    gchar *text;
+
+    if (!g_variant_lookup(client_var, "Address", "&s", &address)) {
+	return;
+    }
+
+    client = g_hash_table_lookup(ap_diagnostic->clients, address);
+
+    if (client == NULL) {
+	int row;
+
+	client = g_malloc(sizeof(APClient));
+	client->address_label = gtk_label_new(address);
+	client->signal_label = gtk_label_new(NULL);
+	client->rx_label = gtk_label_new(NULL);
+	client->tx_label = gtk_label_new(NULL);
+
+	row = g_hash_table_size(ap_diagnostic->clients) + 1;
+	gtk_grid_attach(GTK_GRID(ap_diagnostic->table), client->address_label, 0, row, 1, 1);
+	gtk_grid_attach(GTK_GRID(ap_diagnostic->table), client->signal_label,  1, row, 1, 1);
+	gtk_grid_attach(GTK_GRID(ap_diagnostic->table), client->rx_label,      2, row, 1, 1);
+	gtk_grid_attach(GTK_GRID(ap_diagnostic->table), client->tx_label,      3, row, 1, 1);
+
+	gtk_widget_set_halign(client->address_label, GTK_ALIGN_START);
+	gtk_widget_set_halign(client->signal_label,  GTK_ALIGN_END);
+	gtk_widget_set_halign(client->rx_label,      GTK_ALIGN_END);
+	gtk_widget_set_halign(client->tx_label,      GTK_ALIGN_END);
+
+	g_hash_table_insert(ap_diagnostic->clients, g_strdup(address), client);
+    }
+
+    client->generation = ap_diagnostic->generation;
+
+    {
+	gint16 rssi;
+
+	if (g_variant_lookup(client_var, "RSSI", "n", &rssi)) {
+	    text = g_strdup_printf(_("%d dBm"), rssi);
+	}
+	else {
+	    text = g_strdup("");
+	}
+
+	label_text_update(client->signal_label, text);
+	g_free(text);
+    }
+
+    text = bitrate_format(client_var, "RxBitrate");
+    label_text_update(client->rx_label, text);
+    g_free(text);
+
+    text = bitrate_format(client_var, "TxBitrate");
+    label_text_update(client->tx_label, text);
+    g_free(text);
+}
+
+void ap_diagnostic_client_free(APClient *client) {
+    g_free(client);
+}
+
+APDiagnostic* ap_diagnostic_add(Window *window, GDBusObject *object, GDBusProxy *proxy) {
+    APDiagnostic *ap_diagnostic;
+
+    ap_diagnostic = g_malloc(sizeof(APDiagnostic));
+    ap_diagnostic->proxy = proxy;
+    ap_diagnostic->device = NULL;
+    ap_diagnostic->clients = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) ap_diagnostic_client_free);
+    ap_diagnostic->generation = 0;
+    ap_diagnostic->cancellable = NULL;
+
+    ap_diagnostic->summary_label = gtk_label_new(NULL);
+    gtk_widget_set_halign(ap_diagnostic->summary_label, GTK_ALIGN_START);
+
+    ap_diagnostic->table = gtk_grid_new();
+    gtk_grid_set_column_spacing(GTK_GRID(ap_diagnostic->table), 10);
+    gtk_grid_attach(GTK_GRID(ap_diagnostic->table), new_label_bold(_("Client")),  0, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(ap_diagnostic->table), new_label_bold(_("Signal")),  1, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(ap_diagnostic->table), new_label_bold(_("RX rate")), 2, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(ap_diagnostic->table), new_label_bold(_("TX rate")), 3, 0, 1, 1);
+    gtk_widget_set_visible(ap_diagnostic->table, FALSE);
+
+    ap_diagnostic->box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    g_object_ref_sink(ap_diagnostic->box);
+    gtk_box_append(GTK_BOX(ap_diagnostic->box), ap_diagnostic->summary_label);
+    gtk_box_append(GTK_BOX(ap_diagnostic->box), ap_diagnostic->table);
+
+    /*
+     * iwd only exports this interface while the access point is running, so poll
+     * for as long as the object exists.
+     */
+    ap_diagnostic->poll_id = 0;
+    ap_diagnostic_poll(ap_diagnostic);
+
+    if (global.diagnostic_interval > 0) {
+	ap_diagnostic->poll_id = g_timeout_add(global.diagnostic_interval, (GSourceFunc) ap_diagnostic_poll, ap_diagnostic);
+    }
+
+    couple_register(window, DEVICE_AP_DIAGNOSTIC, 1, ap_diagnostic, object);
+
+    return ap_diagnostic;
+}
+
+void ap_diagnostic_remove(Window *window, APDiagnostic *ap_diagnostic) {
+    couple_unregister(window, DEVICE_AP_DIAGNOSTIC, 1, ap_diagnostic);
+
+    if (ap_diagnostic->poll_id != 0) {
+	g_source_remove(ap_diagnostic->poll_id);
+    }
+
+    if (ap_diagnostic->cancellable) {
+	g_cancellable_cancel(ap_diagnostic->cancellable);
+	g_object_unref(ap_diagnostic->cancellable);
+    }
+
+    g_hash_table_unref(ap_diagnostic->clients);
+    g_object_unref(ap_diagnostic->box);
+    g_free(ap_diagnostic);
+}
+
+void bind_device_ap_diagnostic(Device *device, APDiagnostic *ap_diagnostic) {
+    ap_diagnostic->device = device;
+    gtk_box_append(GTK_BOX(device->master), ap_diagnostic->box);
+}
+
+void unbind_device_ap_diagnostic(Device *device, APDiagnostic *ap_diagnostic) {
+    ap_diagnostic->device = NULL;
+    gtk_box_remove(GTK_BOX(device->master), ap_diagnostic->box);
+}
@@ -0,0 +1,69 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_AP_DIAGNOSTIC_H
+#define _IWGTK_AP_DIAGNOSTIC_H
+
+typedef struct APDiagnostic_s APDiagnostic;
+typedef struct APClient_s APClient;
+typedef struct Device_s Device;
+
+struct APDiagnostic_s {
+    GDBusProxy *proxy;
+    Device *device;
+
+    // Client MAC address -> APClient
+    GHashTable *clients;
+    guint generation;
+
+    guint poll_id;
+    GCancellable *cancellable;
+
+    // Widgets
+    GtkWidget *box;
+    GtkWidget *summary_label;
+    GtkWidget *table;
+};
+
+/*
+ * A row of the client table. Rows which weren't in the latest reply have an old
+ * generation, and are removed.
+ */
+struct APClient_s {
+    GtkWidget *address_label;
+    GtkWidget *signal_label;
+    GtkWidget *rx_label;
+    GtkWidget *tx_label;
+    guint generation;
+};
+
+void ap_diagnostic_aggregate(GVariant *clients, guint *n_clients, guint64 *throughput);
+gchar* ap_diagnostic_summary(guint n_clients, guint64 throughput);
+
+gboolean ap_diagnostic_poll(APDiagnostic *ap_diagnostic);
+void ap_diagnostic_results_cb(GDBusProxy *proxy, GAsyncResult *res, APDiagnostic *ap_diagnostic);
+void ap_diagnostic_client_update(APDiagnostic *ap_diagnostic, GVariant *client);
+void ap_diagnostic_client_free(APClient *client);
+
+APDiagnostic* ap_diagnostic_add(Window *window, GDBusObject *object, GDBusProxy *proxy);
+void ap_diagnostic_remove(Window *window, APDiagnostic *ap_diagnostic);
+void bind_device_ap_diagnostic(Device *device, APDiagnostic *ap_diagnostic);
+void unbind_device_ap_diagnostic(Device *device, APDiagnostic *ap_diagnostic);
+
+#endif
@@ -0,0 +1,484 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+/*
+ * Upper bounds of the histogram buckets, in milliseconds. The last bucket counts
+ * everything else.
+ */
+static const guint connect_latency_bounds[CONNECT_LATENCY_N_BUCKETS - 1] = {
+    250, 500, 750, 1000, 1500, 2000, 3000, 4000, 6000, 8000, 12000, 16000, 24000, 32000
+};
+
+/*
+ * Network object path -> ConnectAttempt
+ */
+static GHashTable *connect_attempts = NULL;
+
+/*
+ * One group per network, keyed like iwd's known network object paths
+ */
+static GKeyFile *connect_latency_store = NULL;
+
+/*
+ * Saves are coalesced: save_id is the pending timeout, and a change which is made
+ * while the file is being written is saved once the write has finished.
+ */
+static guint connect_latency_save_id = 0;
+static gboolean connect_latency_saving = FALSE;
+static gboolean connect_latency_dirty = FALSE;
+
+static gchar* connect_latency_store_path() {
+    return g_build_filename(g_get_user_state_dir(), "iwgtk", CONNECT_LATENCY_FILE, NULL);
+}
+
+static GKeyFile* connect_latency_store_get() {
+    if (connect_latency_store == NULL) {
+	gchar *path;
+	GError *err;
+
+	connect_latency_store = g_key_file_new();
+	path = connect_latency_store_path();
+
+	err = NULL;
+	if (!g_key_file_load_from_file(connect_latency_store, path, G_KEY_FILE_NONE, &err)) {
+	    if (!g_error_matches(err, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+		g_printerr("Failed to load connection latencies from %s: %s\n", path, err->message);
+	    }
+
+	    g_error_free(err);
+	}
+
+	g_free(path);
+    }
+
+    return connect_latency_store;
+}
+
+static void connect_latency_store_save_schedule();
+
+static void connect_latency_store_save_callback(GFile *file, GAsyncResult *res, gpointer user_data) {
+    GError *err;
+
+    err = NULL;
+    if (!g_file_replace_contents_finish(file, res, NULL, &err)) {
+	gchar *path;
+
+	path = g_file_get_path(file);
+	g_printerr("Failed to save connection latencies to %s: %s\n", path, err->message);
+	g_free(path);
+	g_error_free(err);
+    }
+
+    connect_latency_saving = FALSE;
+
+    if (connect_latency_dirty) {
+	connect_latency_store_save_schedule();
+    }
+}
+
+static gboolean connect_latency_store_save(gpointer user_data) {
+    gchar *path, *dir;
+    GFile *file;
+    GBytes *contents;
+
+    connect_latency_save_id = 0;
+    connect_latency_dirty = FALSE;
+    connect_latency_saving = TRUE;
+
+    path = connect_latency_store_path();
+    dir = g_path_get_dirname(path);
+    g_mkdir_with_parents(dir, 0700);
+    g_free(dir);
+
+    {
+	gchar *data;
+	gsize length;
+
+	data = g_key_file_to_data(connect_latency_store, &length, NULL);
+	contents = g_bytes_new_take(data, length);
+    }
+
+    file = g_file_new_for_path(path);
+    g_file_replace_contents_bytes_async(file, contents, NULL, FALSE, G_FILE_CREATE_PRIVATE, NULL, (GAsyncReadyCallback) connect_latency_store_save_callback, NULL);
+    g_object_unref(file);
+    g_bytes_unref(contents);
+    g_free(path);
+
+    return G_SOURCE_REMOVE;
+}
+
+/*
+ * Failovers can make several attempts in quick succession, so they're written out
+ * together, off the main thread.
+ */
+static void connect_latency_store_save_schedule() {
+    connect_latency_dirty = TRUE;
+
+    if (connect_latency_save_id == 0 && !connect_latency_saving) {
+	connect_latency_save_id = g_timeout_add_seconds(CONNECT_LATENCY_SAVE_DELAY, connect_latency_store_save, NULL);
+    }
+}
+
+/*
+ * Writes out any changes which haven't been saved yet, before iwgtk exits.
+ */
+void connect_latency_flush() {
+    gchar *path;
+    GError *err;
+
+    // A write which is still in flight would be cut short
+    if (!connect_latency_dirty && !connect_latency_saving) {
+	return;
+    }
+
+    if (connect_latency_save_id != 0) {
+	g_source_remove(connect_latency_save_id);
+	connect_latency_save_id = 0;
+    }
+
+    path = connect_latency_store_path();
+
+    {
+	gchar *dir;
+
+	dir = g_path_get_dirname(path);
+	g_mkdir_with_parents(dir, 0700);
+	g_free(dir);
+    }
+
+    err = NULL;
+    if (!g_key_file_save_to_file(connect_latency_store, path, &err)) {
+	g_printerr("Failed to save connection latencies to %s: %s\n", path, err->message);
+	g_error_free(err);
+    }
+
+    connect_latency_dirty = FALSE;
+    g_free(path);
+}
+
+static void connect_latency_counter_add(GKeyFile *store, const gchar *key, const gchar *counter, guint64 value) {
+    g_key_file_set_uint64(store, key, counter, g_key_file_get_uint64(store, key, counter, NULL) + value);
+}
+
+static void connect_latency_histogram_add(GKeyFile *store, const gchar *key, const gchar *histogram, gint64 usec) {
+    gint *buckets, buckets_new[CONNECT_LATENCY_N_BUCKETS];
+    gsize n_buckets;
+    guint msec;
+    int i;
+
+    buckets = g_key_file_get_integer_list(store, key, histogram, &n_buckets, NULL);
+
+    for (i = 0; i < CONNECT_LATENCY_N_BUCKETS; i ++) {
+	buckets_new[i] = (buckets != NULL && i < n_buckets) ? buckets[i] : 0;
+    }
+
+    g_free(buckets);
+
+    msec = MAX(usec, 0) / 1000;
+
+    for (i = 0; i < CONNECT_LATENCY_N_BUCKETS - 1; i ++) {
+	if (msec < connect_latency_bounds[i]) {
+	    break;
+	}
+    }
+
+    buckets_new[i] ++;
+    g_key_file_set_integer_list(store, key, histogram, buckets_new, CONNECT_LATENCY_N_BUCKETS);
+}
+
+static void connect_attempt_free(ConnectAttempt *attempt) {
+    g_signal_handler_disconnect(attempt->station_proxy, attempt->handler_update);
+    g_object_unref(attempt->station_proxy);
+    g_free(attempt->network_path);
+    g_free(attempt->key);
+    g_free(attempt);
+}
+
+static gint64 connect_attempt_elapsed(ConnectAttempt *attempt) {
+    gint64 now;
+
+    now = g_get_monotonic_time();
+
+    if (attempt->prompt_start != 0) {
+	attempt->prompt_time += now - attempt->prompt_start;
+	attempt->prompt_start = now;
+    }
+
+    return now - attempt->start - attempt->prompt_time;
+}
+
+/*
+ * Notes the moment at which the station reports that it's connected to the network.
+ */
+static void connect_attempt_station_changed(ConnectAttempt *attempt) {
+    GVariant *state_var, *network_var;
+
+    if (attempt->connected != 0) {
+	return;
+    }
+
+    state_var = g_dbus_proxy_get_cached_property(attempt->station_proxy, "State");
+    network_var = g_dbus_proxy_get_cached_property(attempt->station_proxy, "ConnectedNetwork");
+
+    if (state_var != NULL && network_var != NULL &&
+	!strcmp(g_variant_get_string(state_var, NULL), "connected") &&
+	!strcmp(g_variant_get_string(network_var, NULL), attempt->network_path)) {
+	attempt->connected = connect_attempt_elapsed(attempt);
+    }
+
+    if (state_var != NULL) {
+	g_variant_unref(state_var);
+    }
+
+    if (network_var != NULL) {
+	g_variant_unref(network_var);
+    }
+}
+
+/*
+ * The key under which a network's latencies are stored: the hex-encoded SSID and
+ * the security type, as in iwd's known network object paths.
+ */
+gchar* connect_latency_key(const gchar *ssid, const gchar *type) {
+    GString *key;
+
+    key = g_string_new(NULL);
+
+    for (const gchar *c = ssid; *c != '\0'; c ++) {
+	g_string_append_printf(key, "%02x", (guchar) *c);
+    }
+
+    g_string_append_printf(key, "_%s", type);
+    return g_string_free(key, FALSE);
+}
+
+/*
+ * Called when Network.Connect is sent. If an attempt on the same network is still
+ * in progress, it's the one which gets timed.
+ */
+void connect_latency_begin(GDBusProxy *network_proxy) {
+    ConnectAttempt *attempt;
+    const gchar *network_path;
+    GDBusProxy *station_proxy;
+
+    if (global.manager == NULL) {
+	return;
+    }
+
+    if (connect_attempts == NULL) {
+	connect_attempts = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify) connect_attempt_free);
+    }
+
+    network_path = g_dbus_proxy_get_object_path(network_proxy);
+
+    if (g_hash_table_contains(connect_attempts, network_path)) {
+	return;
+    }
+
+    {
+	GVariant *device_var;
+
+	device_var = g_dbus_proxy_get_cached_property(network_proxy, "Device");
+	station_proxy = G_DBUS_PROXY(g_dbus_object_manager_get_interface(global.manager, g_variant_get_string(device_var, NULL), IWD_IFACE_STATION));
+	g_variant_unref(device_var);
+    }
+
+    if (station_proxy == NULL) {
+	return;
+    }
+
+    attempt = g_malloc(sizeof(ConnectAttempt));
+
+    {
+	GVariant *name_var, *type_var;
+
+	name_var = g_dbus_proxy_get_cached_property(network_proxy, "Name");
+	type_var = g_dbus_proxy_get_cached_property(network_proxy, "Type");
+	attempt->key = connect_latency_key(g_variant_get_string(name_var, NULL), g_variant_get_string(type_var, NULL));
+	g_variant_unref(name_var);
+	g_variant_unref(type_var);
+    }
+
+    attempt->network_path = g_strdup(network_path);
+    attempt->station_proxy = station_proxy;
+    attempt->handler_update = g_signal_connect_swapped(station_proxy, "g-properties-changed", G_CALLBACK(connect_attempt_station_changed), attempt);
+    attempt->start = g_get_monotonic_time();
+    attempt->connected = 0;
+    attempt->prompt_start = 0;
+    attempt->prompt_time = 0;
+
+    g_hash_table_insert(connect_attempts, attempt->network_path, attempt);
+}
+
+/*
+ * Called with iwd's reply to Network.Connect; err is NULL on success. An attempt
+ * which was canceled says nothing about the network, so it isn't recorded.
+ */
+void connect_latency_end(const gchar *network_path, const GError *err) {
+    ConnectAttempt *attempt;
+    GKeyFile *store;
+    gint64 reply;
+
+    if (connect_attempts == NULL || (attempt = g_hash_table_lookup(connect_attempts, network_path)) == NULL) {
+	return;
+    }
+
+    reply = connect_attempt_elapsed(attempt);
+
+    if (g_error_matches(err, global.iwd_error_domain, IWD_ERROR_ABORTED) || g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+	g_hash_table_remove(connect_attempts, network_path);
+	return;
+    }
+
+    store = connect_latency_store_get();
+    connect_latency_counter_add(store, attempt->key, "attempts", 1);
+    connect_latency_counter_add(store, attempt->key, "prompt-time", attempt->prompt_time / 1000);
+
+    if (err == NULL) {
+	// iwd replies once the connection is up, so this is just a fallback
+	if (attempt->connected == 0) {
+	    attempt->connected = reply;
+	}
+
+	connect_latency_histogram_add(store, attempt->key, "connected", attempt->connected);
+	connect_latency_histogram_add(store, attempt->key, "reply", reply);
+    }
+    else {
+	connect_latency_counter_add(store, attempt->key, "failures", 1);
+    }
+
+    connect_latency_store_save_schedule();
+
+    if (global.window != NULL) {
+	known_networks_latency_update(global.window, attempt->key);
+    }
+
+    g_hash_table_remove(connect_attempts, network_path);
+}
+
+/*
+ * Only one credential prompt is shown at a time.
+ */
+void connect_latency_prompt_begin(const gchar *network_path) {
+    ConnectAttempt *attempt;
+
+    if (connect_attempts != NULL && (attempt = g_hash_table_lookup(connect_attempts, network_path)) != NULL) {
+	attempt->prompt_start = g_get_monotonic_time();
+    }
+}
+
+void connect_latency_prompt_end() {
+    GHashTableIter iter;
+    ConnectAttempt *attempt;
+
+    if (connect_attempts == NULL) {
+	return;
+    }
+
+    g_hash_table_iter_init(&iter, connect_attempts);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &attempt)) {
+	if (attempt->prompt_start != 0) {
+	    attempt->prompt_time += g_get_monotonic_time() - attempt->prompt_start;
+	    attempt->prompt_start = 0;
+	}
+    }
+}
+
+/*
+ * Retrieves the median and 95th percentile of the time to connect to a network, in
+ * milliseconds. As with the D-Bus latency histograms, each is the upper bound of the
+ * bucket which contains it; G_MAXUINT stands for the open-ended last bucket.
+ * Returns FALSE if no attempts have been recorded.
+ */
+gboolean connect_latency_summary(const gchar *key, guint *median, guint *p95, guint *attempts, guint *failures) {
+    GKeyFile *store;
+    gint *buckets;
+    gsize n_buckets;
+    guint64 count, sum;
+
+    store = connect_latency_store_get();
+    *attempts = g_key_file_get_uint64(store, key, "attempts", NULL);
+    *failures = g_key_file_get_uint64(store, key, "failures", NULL);
+
+    if (*attempts == 0) {
+	return FALSE;
+    }
+
+    *median = G_MAXUINT;
+    *p95 = G_MAXUINT;
+
+    buckets = g_key_file_get_integer_list(store, key, "connected", &n_buckets, NULL);
+    if (buckets == NULL) {
+	return TRUE;
+    }
+
+    n_buckets = MIN(n_buckets, CONNECT_LATENCY_N_BUCKETS);
+    count = 0;
+
+    for (int i = 0; i < n_buckets; i ++) {
+	count += buckets[i];
+    }
+
+    sum = 0;
+
+    for (int i = 0; i < n_buckets - 1 && count > 0; i ++) {
+	sum += buckets[i];
+
+	if (*median == G_MAXUINT && sum * 2 >= count) {
+	    *median = connect_latency_bounds[i];
+	}
+
+	if (sum * 20 >= count * 19) {
+	    *p95 = connect_latency_bounds[i];
+	    break;
+	}
+    }
+
+    g_free(buckets);
+    return TRUE;
+}
+
+/*
+ * The fraction of recorded attempts on a network which succeeded, smoothed towards
+ * 1/2 so that a network with little history isn't ranked at either extreme.
+ */
+gdouble connect_latency_success_rate(const gchar *key) {
+    GKeyFile *store;
+    guint64 attempts, failures;
+
+    store = connect_latency_store_get();
+    attempts = g_key_file_get_uint64(store, key, "attempts", NULL);
+    failures = g_key_file_get_uint64(store, key, "failures", NULL);
+
+    return (attempts - MIN(failures, attempts) + 1) / (gdouble) (attempts + 2);
+}
+
+gchar* connect_latency_format(guint msec) {
+    if (msec == G_MAXUINT) {
+	return g_strdup_printf(_("> %u s"), connect_latency_bounds[CONNECT_LATENCY_N_BUCKETS - 2] / 1000);
+    }
+    else if (msec < 1000) {
+	return g_strdup_printf(_("≤ %u ms"), msec);
+    }
+    else {
+	return g_strdup_printf(_("≤ %.1f s"), msec / 1000.0);
+    }
+}
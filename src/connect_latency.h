@@ -0,0 +1,57 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_CONNECT_LATENCY_H
+#define _IWGTK_CONNECT_LATENCY_H
+
+#define CONNECT_LATENCY_N_BUCKETS 15
+#define CONNECT_LATENCY_FILE "connect-latency"
+#define CONNECT_LATENCY_SAVE_DELAY 5
+
+typedef struct ConnectAttempt_s ConnectAttempt;
+
+/*
+ * A connection attempt which is waiting for iwd's reply to Network.Connect. Times
+ * are in microseconds, relative to start. The time spent waiting for the user to
+ * enter credentials is tracked separately, so that a slow typist doesn't count
+ * against the network.
+ */
+struct ConnectAttempt_s {
+    gchar *key;
+    gchar *network_path;
+    GDBusProxy *station_proxy;
+    gulong handler_update;
+
+    gint64 start;
+    gint64 connected;
+    gint64 prompt_start;
+    gint64 prompt_time;
+};
+
+gchar* connect_latency_key(const gchar *ssid, const gchar *type);
+void connect_latency_begin(GDBusProxy *network_proxy);
+void connect_latency_end(const gchar *network_path, const GError *err);
+void connect_latency_prompt_begin(const gchar *network_path);
+void connect_latency_prompt_end();
+gboolean connect_latency_summary(const gchar *key, guint *median, guint *p95, guint *attempts, guint *failures);
+gdouble connect_latency_success_rate(const gchar *key);
+gchar* connect_latency_format(guint msec);
+void connect_latency_flush();
+
+#endif
@@ -0,0 +1,255 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+GDBusArgInfo arg_stats = {-1, "stats", "a{sv}", NULL};
+
+GDBusInterfaceInfo debug_interface_info = {
+    -1,
+    IWGTK_IFACE_DEBUG,
+    (GDBusMethodInfo *[]) {
+	&(GDBusMethodInfo) {
+	    -1,
+	    "GetStats",
+	    NULL,
+	    (GDBusArgInfo *[]) {&arg_stats, NULL},
+	    NULL
+	},
+	NULL
+    },
+    NULL, // Signal info
+    NULL, // Property info
+    NULL  // Annotation info
+};
+
+GDBusInterfaceVTable debug_interface_vtable = {
+    (GDBusInterfaceMethodCallFunc) debug_method_call_handler,
+    NULL,
+    NULL
+};
+
+static const gchar* couple_type_names[] = {
+    "adapter-device",
+    "device-station",
+    "device-ap",
+    "device-adhoc",
+    "station-dpp",
+    "station-wps",
+    "device-diagnostic",
+    "device-ap-diagnostic"
+};
+
+void debug_register(GDBusConnection *connection) {
+    GError *err;
+
+    err = NULL;
+    g_dbus_connection_register_object(
+	connection,
+	IWGTK_PATH_DEBUG,
+	&debug_interface_info,
+	&debug_interface_vtable,
+	NULL,
+	NULL,
+	&err);
+
+    if (err != NULL) {
+	g_printerr("Failed to register debug interface: %s\n", err->message);
+	g_error_free(err);
+    }
+}
+
+void debug_method_call_handler(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *parameters, GDBusMethodInvocation *invocation, gpointer user_data) {
+    if (strcmp(method_name, "GetStats") == 0) {
+	g_dbus_method_invocation_return_value(invocation, g_variant_new("(@a{sv})", debug_stats_new()));
+    }
+    else {
+	g_dbus_method_invocation_return_dbus_error(invocation, "org.freedesktop.DBus.Error.UnknownMethod", "Unknown method");
+    }
+}
+
+/*
+ * Returns a floating a{sv} reference containing live object counts and all
+ * performance counters.
+ */
+GVariant* debug_stats_new() {
+    GVariantBuilder builder;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&builder, "{sv}", "version", g_variant_new_string(VERSION));
+
+    if (global.manager) {
+	GList *object_list;
+	guint n_objects, n_proxies;
+
+	n_objects = 0;
+	n_proxies = 0;
+	object_list = g_dbus_object_manager_get_objects(global.manager);
+
+	for (GList *i = object_list; i != NULL; i = i->next) {
+	    GList *interface_list;
+
+	    interface_list = g_dbus_object_get_interfaces(G_DBUS_OBJECT(i->data));
+	    n_proxies += g_list_length(interface_list);
+	    n_objects ++;
+
+	    g_list_free_full(interface_list, g_object_unref);
+	}
+
+	g_list_free_full(object_list, g_object_unref);
+
+	g_variant_builder_add(&builder, "{sv}", "iwd.objects", g_variant_new_uint32(n_objects));
+	g_variant_builder_add(&builder, "{sv}", "iwd.proxies", g_variant_new_uint32(n_proxies));
+    }
+
+    if (global.indicator_manager) {
+	g_variant_builder_add(&builder, "{sv}", "iwd.indicator-objects", g_variant_new_uint32(g_hash_table_size(global.indicator_manager->objects)));
+	g_variant_builder_add(&builder, "{sv}", "iwd.indicator-proxies", g_variant_new_uint32(indicator_manager_count_proxies(global.indicator_manager)));
+    }
+
+    {
+	guint n_indicators;
+
+	n_indicators = 0;
+	for (Indicator *indicator = global.indicators; indicator != NULL; indicator = indicator->next) {
+	    n_indicators ++;
+	}
+
+	g_variant_builder_add(&builder, "{sv}", "indicators", g_variant_new_uint32(n_indicators));
+    }
+
+    if (global.window) {
+	for (int i = 0; i < n_object_types; i ++) {
+	    guint n;
+	    gchar *key;
+
+	    n = 0;
+	    for (ObjectList *list = global.window->objects[i]; list != NULL; list = list->next) {
+		n ++;
+	    }
+
+	    key = g_strdup_printf("window.objects.%s", object_methods[i].interface);
+	    g_variant_builder_add(&builder, "{sv}", key, g_variant_new_uint32(n));
+	    g_free(key);
+	}
+
+	for (int i = 0; i < n_couple_types; i ++) {
+	    guint n;
+	    gchar *key;
+
+	    n = 0;
+	    for (CoupleList *list = global.window->couples[i]; list != NULL; list = list->next) {
+		n ++;
+	    }
+
+	    key = g_strdup_printf("window.couples.%s", couple_type_names[i]);
+	    g_variant_builder_add(&builder, "{sv}", key, g_variant_new_uint32(n));
+	    g_free(key);
+	}
+    }
+
+    g_variant_builder_add(&builder, "{sv}", "signal-agents", g_variant_new_uint32(signal_agents_count()));
+    g_variant_builder_add(&builder, "{sv}", "icons.rendered", g_variant_new_uint64(icons_rendered));
+    g_variant_builder_add(&builder, "{sv}", "dbus.pending-calls", g_variant_new_uint32(stats_dbus_pending_calls()));
+    stats_dbus_collect(&builder);
+    watchdog_collect(&builder);
+    startup_collect(&builder);
+
+    return g_variant_builder_end(&builder);
+}
+
+/*
+ * SIGUSR1 handler: write the current statistics to stderr.
+ */
+gboolean debug_stats_dump() {
+    GVariant *stats;
+    gchar *stats_str;
+
+    stats = g_variant_ref_sink(debug_stats_new());
+    stats_str = stats_format(stats);
+    g_printerr("%s", stats_str);
+
+    g_free(stats_str);
+    g_variant_unref(stats);
+    return G_SOURCE_CONTINUE;
+}
+
+/*
+ * Client side of --stats: query the running primary instance and print its
+ * statistics.
+ */
+gint debug_stats_print() {
+    static const gchar *names[] = {APPLICATION_ID, APPLICATION_ID_LIGHT, NULL};
+    GDBusConnection *connection;
+    GVariant *ret;
+    GError *err;
+
+    err = NULL;
+    connection = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, &err);
+
+    if (connection == NULL) {
+	g_printerr("Failed to connect to session bus: %s\n", err->message);
+	g_error_free(err);
+	return 1;
+    }
+
+    /*
+     * Either the full application or the lightweight indicator daemon may be
+     * running.
+     */
+    ret = NULL;
+    for (int i = 0; names[i] != NULL && ret == NULL; i ++) {
+	g_clear_error(&err);
+	ret = g_dbus_connection_call_sync(
+	    connection,
+	    names[i],
+	    IWGTK_PATH_DEBUG,
+	    IWGTK_IFACE_DEBUG,
+	    "GetStats",
+	    NULL,
+	    G_VARIANT_TYPE("(a{sv})"),
+	    G_DBUS_CALL_FLAGS_NO_AUTO_START,
+	    -1,
+	    NULL,
+	    &err);
+    }
+
+    g_object_unref(connection);
+
+    if (ret == NULL) {
+	g_printerr("Failed to retrieve statistics from running iwgtk instance: %s\n", err->message);
+	g_error_free(err);
+	return 1;
+    }
+
+    {
+	GVariant *stats;
+	gchar *stats_str;
+
+	stats = g_variant_get_child_value(ret, 0);
+	stats_str = stats_format(stats);
+	fputs(stats_str, stdout);
+
+	g_free(stats_str);
+	g_variant_unref(stats);
+    }
+
+    g_variant_unref(ret);
+    return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_DEBUG_H
+#define _IWGTK_DEBUG_H
+
+#define IWGTK_PATH_DEBUG  "/org/twosheds/iwgtk/Debug"
+#define IWGTK_IFACE_DEBUG "org.twosheds.iwgtk.Debug"
+
+void debug_register(GDBusConnection *connection);
+void debug_method_call_handler(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *parameters, GDBusMethodInvocation *invocation, gpointer user_data);
+GVariant* debug_stats_new();
+gboolean debug_stats_dump();
+gint debug_stats_print();
+
+#endif
@@ -40,9 +40,13 @@ void device_set(Device *device) {
 	GVariant *mode_var;
 	const gchar *mode;
 
-	mode_var = g_dbus_proxy_get_cached_property(device->proxy, "Mode");
+	mode_var = pending_property_get(device->proxy, "Mode");
 	mode = g_variant_get_string(mode_var, NULL);
+
+	g_signal_handlers_block_by_func(device->mode_box, mode_box_changed, device);
 	gtk_combo_box_set_active_id(GTK_COMBO_BOX(device->mode_box), mode);
+	g_signal_handlers_unblock_by_func(device->mode_box, mode_box_changed, device);
+
 	g_variant_unref(mode_var);
     }
 }
@@ -51,7 +55,7 @@ void mode_box_changed(GtkComboBox *box, Device *device) {
     const gchar *mode;
 
     mode = gtk_combo_box_get_active_id(box);
-    set_remote_property(device->proxy, "Mode", g_variant_new_string(mode), (SetFunction) device_set, device);
+    pending_property_set(device->proxy, "Mode", g_variant_new_string(mode), (PendingRefresh) device_set, device);
 }
 
 GtkWidget* mode_box_new(GDBusProxy *adapter_proxy) {
@@ -102,11 +106,46 @@ GtkWidget* mode_box_new(GDBusProxy *adapter_proxy) {
     return box;
 }
 
+void device_throughput_set(gdouble rx_rate, gdouble tx_rate, Device *device) {
+    gchar *text;
+
+    text = throughput_format(rx_rate, tx_rate);
+    gtk_label_set_text(GTK_LABEL(device->throughput_label), text);
+    g_free(text);
+}
+
+/*
+ * The interface's counters are only sampled while its page is on screen.
+ */
+void device_throughput_map(Device *device) {
+    GVariant *name_var;
+
+    if (device->throughput_interface != NULL) {
+	return;
+    }
+
+    name_var = g_dbus_proxy_get_cached_property(device->proxy, "Name");
+    device->throughput_interface = g_variant_dup_string(name_var, NULL);
+    g_variant_unref(name_var);
+
+    gtk_label_set_text(GTK_LABEL(device->throughput_label), "—");
+    throughput_subscribe(device->throughput_interface, (ThroughputCallback) device_throughput_set, device);
+}
+
+void device_throughput_unmap(Device *device) {
+    if (device->throughput_interface != NULL) {
+	throughput_unsubscribe(device->throughput_interface, (ThroughputCallback) device_throughput_set, device);
+	g_free(device->throughput_interface);
+	device->throughput_interface = NULL;
+    }
+}
+
 Device* device_add(Window *window, GDBusObject *object, GDBusProxy *proxy) {
     Device *device;
 
     device = g_malloc(sizeof(Device));
     device->proxy = proxy;
+    device->throughput_interface = NULL;
 
     {
 	GVariant *name_var;
@@ -161,6 +200,12 @@ Device* device_add(Window *window, GDBusObject *object, GDBusProxy *proxy) {
     g_object_ref_sink(device->mac_label);
     gtk_widget_set_tooltip_text(GTK_WIDGET(device->mac_label), _("MAC address"));
 
+    device->throughput_label = gtk_label_new(NULL);
+    g_object_ref_sink(device->throughput_label);
+    gtk_widget_set_tooltip_text(GTK_WIDGET(device->throughput_label), _("Receive and transmit rates"));
+    g_signal_connect_swapped(device->throughput_label, "map", G_CALLBACK(device_throughput_map), device);
+    g_signal_connect_swapped(device->throughput_label, "unmap", G_CALLBACK(device_throughput_unmap), device);
+
     {
 	GtkWidget *up_label, *mode_label, *power_switch;
 
@@ -170,7 +215,8 @@ Device* device_add(Window *window, GDBusObject *object, GDBusProxy *proxy) {
 	up_label = gtk_label_new(_("Enabled: "));
 	mode_label = gtk_label_new(_("Mode: "));
 
-	gtk_grid_attach(GTK_GRID(device->table), device->mac_label, 0, 0, 1, 1);
+	gtk_grid_attach(GTK_GRID(device->table), device->mac_label,        0, 0, 1, 1);
+	gtk_grid_attach(GTK_GRID(device->table), device->throughput_label, 0, 1, 1, 1);
 
 	gtk_grid_attach(GTK_GRID(device->table), up_label,          1, 0, 1, 1);
 	gtk_grid_attach(GTK_GRID(device->table), power_switch,      2, 0, 1, 1);
@@ -184,6 +230,7 @@ Device* device_add(Window *window, GDBusObject *object, GDBusProxy *proxy) {
 
 	gtk_widget_set_halign(device->mac_label, GTK_ALIGN_CENTER);
 	gtk_widget_set_size_request(device->mac_label, -1, 34);
+	gtk_widget_set_halign(device->throughput_label, GTK_ALIGN_CENTER);
 
 	gtk_widget_set_halign(up_label, GTK_ALIGN_END);
 	gtk_widget_set_halign(mode_label, GTK_ALIGN_END);
@@ -192,6 +239,7 @@ Device* device_add(Window *window, GDBusObject *object, GDBusProxy *proxy) {
 	gtk_widget_set_halign(device->mode_box, GTK_ALIGN_START);
 
 	gtk_widget_set_valign(device->mac_label, GTK_ALIGN_CENTER);
+	gtk_widget_set_valign(device->throughput_label, GTK_ALIGN_CENTER);
 
 	gtk_widget_set_valign(up_label, GTK_ALIGN_CENTER);
 	gtk_widget_set_valign(mode_label, GTK_ALIGN_CENTER);
@@ -208,16 +256,19 @@ Device* device_add(Window *window, GDBusObject *object, GDBusProxy *proxy) {
 
     g_signal_connect(device->mode_box, "changed", G_CALLBACK(mode_box_changed), device);
 
-    couple_register(window, DEVICE_STATION,    0, device, object);
-    couple_register(window, DEVICE_AP,         0, device, object);
-    couple_register(window, DEVICE_ADHOC,      0, device, object);
-    couple_register(window, DEVICE_DIAGNOSTIC, 0, device, object);
+    couple_register(window, DEVICE_STATION,       0, device, object);
+    couple_register(window, DEVICE_AP,            0, device, object);
+    couple_register(window, DEVICE_ADHOC,         0, device, object);
+    couple_register(window, DEVICE_DIAGNOSTIC,    0, device, object);
+    couple_register(window, DEVICE_AP_DIAGNOSTIC, 0, device, object);
 
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(device->button), TRUE);
     return device;
 }
 
 void device_remove(Window *window, Device *device) {
+    pending_refresh_cancel(device);
+
     if (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(device->button))) {
 	ObjectList *device_list;
 	GtkWidget *button_alt;
@@ -247,18 +298,23 @@ void device_remove(Window *window, Device *device) {
 	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(button_alt), TRUE);
     }
 
-    couple_unregister(window, DEVICE_STATION,    0, device);
-    couple_unregister(window, DEVICE_AP,         0, device);
-    couple_unregister(window, DEVICE_ADHOC,      0, device);
-    couple_unregister(window, DEVICE_DIAGNOSTIC, 0, device);
+    couple_unregister(window, DEVICE_STATION,       0, device);
+    couple_unregister(window, DEVICE_AP,            0, device);
+    couple_unregister(window, DEVICE_ADHOC,         0, device);
+    couple_unregister(window, DEVICE_DIAGNOSTIC,    0, device);
+    couple_unregister(window, DEVICE_AP_DIAGNOSTIC, 0, device);
 
     couple_unregister(window, ADAPTER_DEVICE, 1, device);
 
+    g_signal_handlers_disconnect_by_data(device->throughput_label, device);
+    device_throughput_unmap(device);
+
     g_object_unref(device->button);
     g_object_unref(device->mode_box);
     g_object_unref(device->master);
     g_object_unref(device->table);
     g_object_unref(device->mac_label);
+    g_object_unref(device->throughput_label);
 
     g_signal_handler_disconnect(device->proxy, device->handler_update);
     g_free(device);
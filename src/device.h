@@ -34,6 +34,10 @@ struct Device_s {
     GtkWidget *table;
     GtkWidget *mac_label;
     GtkWidget *mode_box;
+    GtkWidget *throughput_label;
+
+    // Interface whose throughput is shown, while the device page is visible
+    gchar *throughput_interface;
 
     // Handlers
     gulong handler_update;
@@ -43,6 +47,9 @@ void device_show(GtkToggleButton *button, Device *device);
 void device_set(Device *device);
 void mode_box_changed(GtkComboBox *box, Device *device);
 GtkWidget* mode_box_new(GDBusProxy *adapter_proxy);
+void device_throughput_set(gdouble rx_rate, gdouble tx_rate, Device *device);
+void device_throughput_map(Device *device);
+void device_throughput_unmap(Device *device);
 Device* device_add(Window *window, GDBusObject *object, GDBusProxy *proxy);
 void device_remove(Window *window, Device *device);
 
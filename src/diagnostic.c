@@ -19,92 +19,246 @@
 
 #include "iwgtk.h"
 
+/*
+ * The diagnostics window stays open and polls GetDiagnostics every
+ * global.diagnostic_interval milliseconds; only the values which change are updated.
+ */
 void diagnostic_launch(Diagnostic *diagnostic) {
-    g_dbus_proxy_call(
-	diagnostic->proxy,
-	"GetDiagnostics",
-	NULL,
-	G_DBUS_CALL_FLAGS_NONE,
-	-1,
-	NULL,
-	(GAsyncReadyCallback) diagnostic_results_cb,
-	diagnostic);
+    if (diagnostic->window) {
+	gtk_window_present(GTK_WINDOW(diagnostic->window));
+	return;
+    }
+
+    diagnostic_window_new(diagnostic);
+    diagnostic_poll(diagnostic);
+
+    if (global.diagnostic_interval > 0) {
+	diagnostic->poll_id = g_timeout_add(global.diagnostic_interval, (GSourceFunc) diagnostic_poll, diagnostic);
+    }
+}
+
+gboolean diagnostic_poll(Diagnostic *diagnostic) {
+    // Don't stack up requests if iwd is slow to reply
+    if (diagnostic->cancellable == NULL) {
+	diagnostic->cancellable = g_cancellable_new();
+
+	g_dbus_proxy_call(
+	    diagnostic->proxy,
+	    "GetDiagnostics",
+	    NULL,
+	    G_DBUS_CALL_FLAGS_NONE,
+	    -1,
+	    diagnostic->cancellable,
+	    (GAsyncReadyCallback) diagnostic_results_cb,
+	    diagnostic);
+    }
+
+    return G_SOURCE_CONTINUE;
 }
 
 void diagnostic_results_cb(GDBusProxy *proxy, GAsyncResult *res, Diagnostic *diagnostic) {
     GVariant *diagnostics_data;
     GError *err;
 
+    watchdog_mark("GetDiagnostics reply");
+
     err = NULL;
     diagnostics_data = g_dbus_proxy_call_finish(proxy, res, &err);
 
+    // The window has been closed
+    if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+	g_error_free(err);
+	return;
+    }
+
+    g_clear_object(&diagnostic->cancellable);
+
     if (diagnostics_data) {
-	GtkWidget *table;
-	GtkWidget *property;
-	GtkWidget *value;
+	GVariantIter *iter;
+	const gchar *property;
+	GVariant *value;
 
-	table = gtk_grid_new();
-	gtk_grid_set_column_spacing(GTK_GRID(table), 10);
+	gtk_widget_set_visible(diagnostic->status_label, FALSE);
+	g_variant_get(diagnostics_data, "(a{sv})", &iter);
 
-	gtk_widget_set_margin_start(table, 5);
-	gtk_widget_set_margin_end(table, 5);
-	gtk_widget_set_margin_top(table, 5);
-	gtk_widget_set_margin_bottom(table, 5);
+	while (g_variant_iter_next(iter, "{&sv}", &property, &value)) {
+	    diagnostic_row_update(diagnostic, property, value);
+	    g_variant_unref(value);
+	}
 
-	property = new_label_bold(_("Property"));
-	value = new_label_bold(_("Value"));
-	diagnostic_table_insert(table, property, value, 0);
+	g_variant_iter_free(iter);
+	g_variant_unref(diagnostics_data);
+    }
+    else {
+	// E.g. the station has disconnected; keep showing the last values
+	gtk_label_set_text(GTK_LABEL(diagnostic->status_label), err->message);
+	gtk_widget_set_visible(diagnostic->status_label, TRUE);
+	g_error_free(err);
+    }
+}
+
+gboolean diagnostic_value_numeric(GVariant *value, gint64 *number) {
+    switch (g_variant_classify(value)) {
+	case G_VARIANT_CLASS_BYTE:
+	    *number = g_variant_get_byte(value);
+	    return TRUE;
+	case G_VARIANT_CLASS_INT16:
+	    *number = g_variant_get_int16(value);
+	    return TRUE;
+	case G_VARIANT_CLASS_UINT16:
+	    *number = g_variant_get_uint16(value);
+	    return TRUE;
+	case G_VARIANT_CLASS_INT32:
+	    *number = g_variant_get_int32(value);
+	    return TRUE;
+	case G_VARIANT_CLASS_UINT32:
+	    *number = g_variant_get_uint32(value);
+	    return TRUE;
+	case G_VARIANT_CLASS_INT64:
+	    *number = g_variant_get_int64(value);
+	    return TRUE;
+	case G_VARIANT_CLASS_UINT64:
+	    *number = (gint64) g_variant_get_uint64(value);
+	    return TRUE;
+	default:
+	    return FALSE;
+    }
+}
+
+void diagnostic_row_update(Diagnostic *diagnostic, const gchar *property, GVariant *value) {
+    DiagnosticRow *row;
+    gchar *value_str;
+    gint64 number;
+    gboolean numeric;
+
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING)) {
+	value_str = g_variant_dup_string(value, NULL);
+    }
+    else {
+	value_str = g_variant_print(value, FALSE);
+    }
 
-	{
-	    GVariantIter *iter;
-	    const gchar *property_str;
-	    GVariant *value_var;
-	    int i = 1;
+    numeric = diagnostic_value_numeric(value, &number);
+    row = g_hash_table_lookup(diagnostic->rows, property);
 
-	    g_variant_get(diagnostics_data, "(a{sv})", &iter);
+    if (row == NULL) {
+	GtkWidget *property_label;
 
-	    while (g_variant_iter_next(iter, "{&sv}", &property_str, &value_var)) {
-		property = gtk_label_new(property_str);
+	row = g_malloc(sizeof(DiagnosticRow));
+	row->value = NULL;
+	row->head = 0;
+	row->n_samples = 0;
 
-		if (g_variant_is_of_type(value_var, G_VARIANT_TYPE_STRING)) {
-		    value = gtk_label_new(g_variant_get_string(value_var, NULL));
-		}
-		else {
-		    gchar *value_str;
+	property_label = gtk_label_new(property);
+	row->value_label = gtk_label_new(NULL);
 
-		    value_str = g_variant_print(value_var, FALSE);
-		    value = gtk_label_new(value_str);
-		    g_free(value_str);
-		}
+	gtk_widget_set_halign(property_label, GTK_ALIGN_END);
+	gtk_widget_set_halign(row->value_label, GTK_ALIGN_START);
 
-		diagnostic_table_insert(table, property, value, i ++);
-		g_variant_unref(value_var);
-	    }
+	gtk_grid_attach(GTK_GRID(diagnostic->table), property_label,   0, diagnostic->n_rows, 1, 1);
+	gtk_grid_attach(GTK_GRID(diagnostic->table), row->value_label, 1, diagnostic->n_rows, 1, 1);
 
-	    g_variant_iter_free(iter);
+	if (numeric) {
+	    row->graph = gtk_drawing_area_new();
+	    gtk_drawing_area_set_content_width(GTK_DRAWING_AREA(row->graph), DIAGNOSTIC_GRAPH_WIDTH);
+	    gtk_drawing_area_set_content_height(GTK_DRAWING_AREA(row->graph), DIAGNOSTIC_GRAPH_HEIGHT);
+	    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(row->graph), (GtkDrawingAreaDrawFunc) diagnostic_graph_draw, row, NULL);
+	    gtk_grid_attach(GTK_GRID(diagnostic->table), row->graph, 2, diagnostic->n_rows, 1, 1);
+	}
+	else {
+	    row->graph = NULL;
 	}
 
-	g_variant_unref(diagnostics_data);
-	diagnostic_window_show(diagnostic, table);
+	g_hash_table_insert(diagnostic->rows, g_strdup(property), row);
+	diagnostic->n_rows ++;
+    }
+
+    if (g_strcmp0(row->value, value_str) != 0) {
+	gtk_label_set_text(GTK_LABEL(row->value_label), value_str);
+	g_free(row->value);
+	row->value = value_str;
     }
     else {
-	g_printerr("Failed to retrieve diagnostics: %s\n", err->message);
-	g_error_free(err);
+	g_free(value_str);
     }
+
+    if (numeric && row->graph) {
+	if (row->n_samples < DIAGNOSTIC_HISTORY_LEN) {
+	    row->samples[(row->head + row->n_samples) % DIAGNOSTIC_HISTORY_LEN] = number;
+	    row->n_samples ++;
+	}
+	else {
+	    row->samples[row->head] = number;
+	    row->head = (row->head + 1) % DIAGNOSTIC_HISTORY_LEN;
+	}
+
+	gtk_widget_queue_draw(row->graph);
+    }
+}
+
+void diagnostic_row_free(DiagnosticRow *row) {
+    g_free(row->value);
+    g_free(row);
 }
 
-void diagnostic_table_insert(GtkWidget *table, GtkWidget *property, GtkWidget *value, int row) {
-    gtk_widget_set_halign(property, GTK_ALIGN_END);
-    gtk_widget_set_halign(value, GTK_ALIGN_START);
+/*
+ * The graph is scaled to the range of the values which it shows.
+ */
+void diagnostic_graph_draw(GtkDrawingArea *area, cairo_t *cr, int width, int height, DiagnosticRow *row) {
+    GdkRGBA color;
+    gint64 min, max;
+    double step;
+
+    if (row->n_samples < 2) {
+	return;
+    }
+
+    min = max = row->samples[row->head];
+
+    for (guint i = 1; i < row->n_samples; i ++) {
+	gint64 sample;
+
+	sample = row->samples[(row->head + i) % DIAGNOSTIC_HISTORY_LEN];
+	min = MIN(min, sample);
+	max = MAX(max, sample);
+    }
+
+    if (min == max) {
+	min --;
+	max ++;
+    }
+
+    gtk_widget_get_color(GTK_WIDGET(area), &color);
+    gdk_cairo_set_source_rgba(cr, &color);
+    cairo_set_line_width(cr, 1.5);
+    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+
+    // The newest value is at the right edge
+    step = (double) (width - 2) / (DIAGNOSTIC_HISTORY_LEN - 1);
+
+    for (guint i = 0; i < row->n_samples; i ++) {
+	double x, y;
 
-    gtk_grid_attach(GTK_GRID(table), property, 0, row, 1, 1);
-    gtk_grid_attach(GTK_GRID(table), value,    1, row, 1, 1);
+	x = width - 1 - (row->n_samples - 1 - i) * step;
+	y = 1 + (double) (max - row->samples[(row->head + i) % DIAGNOSTIC_HISTORY_LEN]) / (max - min) * (height - 2);
+
+	if (i == 0) {
+	    cairo_move_to(cr, x, y);
+	}
+	else {
+	    cairo_line_to(cr, x, y);
+	}
+    }
+
+    cairo_stroke(cr);
 }
 
-void diagnostic_window_show(Diagnostic *diagnostic, GtkWidget *table) {
-    GtkWidget *window;
+void diagnostic_window_new(Diagnostic *diagnostic) {
+    GtkWidget *vbox;
 
-    window = gtk_window_new();
+    diagnostic->window = gtk_window_new();
+    diagnostic->rows = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) diagnostic_row_free);
+    diagnostic->n_rows = 1;
 
     {
 	GVariant *device_name_var;
@@ -117,7 +271,7 @@ void diagnostic_window_show(Diagnostic *diagnostic, GtkWidget *table) {
 	window_title = g_strdup_printf(_("%s: Diagnostics"), device_name);
 	g_variant_unref(device_name_var);
 
-	gtk_window_set_title(GTK_WINDOW(window), window_title);
+	gtk_window_set_title(GTK_WINDOW(diagnostic->window), window_title);
 	g_free(window_title);
     }
 
@@ -125,12 +279,46 @@ void diagnostic_window_show(Diagnostic *diagnostic, GtkWidget *table) {
 	GtkEventController *controller;
 
 	controller = gtk_event_controller_key_new();
-	g_signal_connect(controller, "key-pressed", G_CALLBACK(diagnostic_key_press), window);
-	gtk_widget_add_controller(window, controller);
+	g_signal_connect(controller, "key-pressed", G_CALLBACK(diagnostic_key_press), diagnostic->window);
+	gtk_widget_add_controller(diagnostic->window, controller);
+    }
+
+    diagnostic->table = gtk_grid_new();
+    gtk_grid_set_column_spacing(GTK_GRID(diagnostic->table), 10);
+    gtk_grid_attach(GTK_GRID(diagnostic->table), new_label_bold(_("Property")), 0, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(diagnostic->table), new_label_bold(_("Value")),    1, 0, 1, 1);
+
+    diagnostic->status_label = gtk_label_new(NULL);
+    gtk_widget_set_visible(diagnostic->status_label, FALSE);
+
+    vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    gtk_box_append(GTK_BOX(vbox), diagnostic->status_label);
+    gtk_box_append(GTK_BOX(vbox), diagnostic->table);
+
+    gtk_widget_set_margin_start(vbox, 5);
+    gtk_widget_set_margin_end(vbox, 5);
+    gtk_widget_set_margin_top(vbox, 5);
+    gtk_widget_set_margin_bottom(vbox, 5);
+
+    g_signal_connect_swapped(diagnostic->window, "destroy", G_CALLBACK(diagnostic_window_destroy), diagnostic);
+
+    gtk_window_set_child(GTK_WINDOW(diagnostic->window), vbox);
+    gtk_widget_set_visible(diagnostic->window, true);
+}
+
+void diagnostic_window_destroy(Diagnostic *diagnostic) {
+    if (diagnostic->poll_id != 0) {
+	g_source_remove(diagnostic->poll_id);
+	diagnostic->poll_id = 0;
     }
 
-    gtk_window_set_child(GTK_WINDOW(window), table);
-    gtk_widget_set_visible(window, true);
+    if (diagnostic->cancellable) {
+	g_cancellable_cancel(diagnostic->cancellable);
+	g_clear_object(&diagnostic->cancellable);
+    }
+
+    g_hash_table_unref(diagnostic->rows);
+    diagnostic->window = NULL;
 }
 
 gboolean diagnostic_key_press(GtkEventControllerKey *controller, guint keyval, guint keycode, GdkModifierType state, GtkWindow *window) {
@@ -146,6 +334,9 @@ Diagnostic* diagnostic_add(Window *window, GDBusObject *object, GDBusProxy *prox
 
     diagnostic = g_malloc(sizeof(Diagnostic));
     diagnostic->proxy = proxy;
+    diagnostic->window = NULL;
+    diagnostic->poll_id = 0;
+    diagnostic->cancellable = NULL;
 
     diagnostic->button = gtk_button_new_with_label(_("Diagnostics"));
     g_object_ref_sink(diagnostic->button);
@@ -157,6 +348,10 @@ Diagnostic* diagnostic_add(Window *window, GDBusObject *object, GDBusProxy *prox
 }
 
 void diagnostic_remove(Window *window, Diagnostic *diagnostic) {
+    if (diagnostic->window) {
+	gtk_window_destroy(GTK_WINDOW(diagnostic->window));
+    }
+
     couple_unregister(window, DEVICE_DIAGNOSTIC, 1, diagnostic);
     g_object_unref(diagnostic->button);
     g_free(diagnostic);
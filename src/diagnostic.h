@@ -20,18 +20,51 @@
 #ifndef _IWGTK_DIAGNOSTIC_H
 #define _IWGTK_DIAGNOSTIC_H
 
+#define DIAGNOSTIC_HISTORY_LEN 60
+#define DIAGNOSTIC_GRAPH_WIDTH 120
+#define DIAGNOSTIC_GRAPH_HEIGHT 20
+
 typedef struct Diagnostic_s Diagnostic;
+typedef struct DiagnosticRow_s DiagnosticRow;
 
 struct Diagnostic_s {
     GDBusProxy *proxy;
     GDBusProxy *device_proxy;
     GtkWidget *button;
+
+    // Live diagnostics window; NULL while it's closed
+    GtkWidget *window;
+    GtkWidget *table;
+    GtkWidget *status_label;
+    GHashTable *rows;
+    gint n_rows;
+    guint poll_id;
+    GCancellable *cancellable;
+};
+
+/*
+ * A property in the diagnostics window. Numeric properties keep their most recent
+ * values, oldest first starting at samples[head], and show them as a graph.
+ */
+struct DiagnosticRow_s {
+    GtkWidget *value_label;
+    GtkWidget *graph;
+    gchar *value;
+
+    gint64 samples[DIAGNOSTIC_HISTORY_LEN];
+    guint8 head;
+    guint8 n_samples;
 };
 
 void diagnostic_launch(Diagnostic *diagnostic);
+gboolean diagnostic_poll(Diagnostic *diagnostic);
 void diagnostic_results_cb(GDBusProxy *proxy, GAsyncResult *res, Diagnostic *diagnostic);
-void diagnostic_table_insert(GtkWidget *table, GtkWidget *property, GtkWidget *value, int row);
-void diagnostic_window_show(Diagnostic *diagnostic, GtkWidget *table);
+gboolean diagnostic_value_numeric(GVariant *value, gint64 *number);
+void diagnostic_row_update(Diagnostic *diagnostic, const gchar *property, GVariant *value);
+void diagnostic_row_free(DiagnosticRow *row);
+void diagnostic_graph_draw(GtkDrawingArea *area, cairo_t *cr, int width, int height, DiagnosticRow *row);
+void diagnostic_window_new(Diagnostic *diagnostic);
+void diagnostic_window_destroy(Diagnostic *diagnostic);
 gboolean diagnostic_key_press(GtkEventControllerKey *controller, guint keyval, guint keycode, GdkModifierType state, GtkWindow *window);
 
 Diagnostic* diagnostic_add(Window *window, GDBusObject *object, GDBusProxy *proxy);
@@ -22,9 +22,19 @@
 
 #define QR_CODE_MARGIN 4
 
-void qrcode_draw(GtkDrawingArea *area, cairo_t *cr, int width, int height, cairo_surface_t *qr_surface) {
+/*
+ * Until the QR code has been encoded, only the widget's white background is drawn.
+ */
+void qrcode_draw(GtkDrawingArea *area, cairo_t *cr, int width, int height, gpointer user_data) {
+    cairo_surface_t *qr_surface;
     cairo_pattern_t *qr_pattern;
 
+    qr_surface = g_object_get_data(G_OBJECT(area), "qr-surface");
+
+    if (qr_surface == NULL) {
+	return;
+    }
+
     {
 	float sx, sy;
 
@@ -41,7 +51,7 @@ void qrcode_draw(GtkDrawingArea *area, cairo_t *cr, int width, int height, cairo
     cairo_paint(cr);
 }
 
-GtkWidget* qrcode_widget_new(const gchar *uri) {
+void qrcode_encode_thread(GTask *task, GtkWidget *area, const gchar *uri, GCancellable *cancellable) {
     QRcode *qrcode;
     cairo_surface_t *qr_surface;
     uint32_t *qr_data;
@@ -51,8 +61,8 @@ GtkWidget* qrcode_widget_new(const gchar *uri) {
     qrcode = QRcode_encodeString8bit(uri, 0, QR_ECLEVEL_L);
 
     if (!qrcode) {
-	g_printerr("Failed to generate QR code\n");
-	return NULL;
+	g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED, "Failed to generate QR code");
+	return;
     }
 
     width_data = qrcode->width;
@@ -85,30 +95,62 @@ GtkWidget* qrcode_widget_new(const gchar *uri) {
     cairo_surface_mark_dirty(qr_surface);
     QRcode_free(qrcode);
 
-    {
-	GtkWidget *area;
+    g_task_return_pointer(task, qr_surface, (GDestroyNotify) cairo_surface_destroy);
+}
 
-	area = gtk_drawing_area_new();
+void qrcode_encode_callback(GtkWidget *area, GAsyncResult *res, gpointer user_data) {
+    cairo_surface_t *qr_surface;
+    GError *err;
 
-	gtk_drawing_area_set_content_width(GTK_DRAWING_AREA(area), PROVISION_MENU_WIDTH);
-	gtk_drawing_area_set_content_height(GTK_DRAWING_AREA(area), PROVISION_MENU_WIDTH);
+    err = NULL;
+    qr_surface = g_task_propagate_pointer(G_TASK(res), &err);
 
-	{
-	    GtkStyleContext *context;
-	    GtkCssProvider *provider;
+    if (qr_surface == NULL) {
+	g_printerr("%s\n", err->message);
+	g_error_free(err);
+	return;
+    }
 
-	    context = gtk_widget_get_style_context(area);
+    g_object_set_data_full(G_OBJECT(area), "qr-surface", qr_surface, (GDestroyNotify) cairo_surface_destroy);
+    gtk_widget_queue_draw(area);
+}
 
-	    provider = gtk_css_provider_new();
-	    gtk_css_provider_load_from_string(provider, "* {background: white;}");
-	    gtk_style_context_add_provider(context, GTK_STYLE_PROVIDER(provider), GTK_STYLE_PROVIDER_PRIORITY_USER + 1);
-	    g_object_unref(provider);
-	}
+/*
+ * Returns a drawing area immediately; the QR code itself is encoded on GLib's worker
+ * thread pool and drawn once it is ready.
+ */
+GtkWidget* qrcode_widget_new(const gchar *uri) {
+    GtkWidget *area;
+
+    area = gtk_drawing_area_new();
+
+    gtk_drawing_area_set_content_width(GTK_DRAWING_AREA(area), PROVISION_MENU_WIDTH);
+    gtk_drawing_area_set_content_height(GTK_DRAWING_AREA(area), PROVISION_MENU_WIDTH);
+
+    {
+	GtkStyleContext *context;
+	GtkCssProvider *provider;
 
-	gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(area), (GtkDrawingAreaDrawFunc) qrcode_draw, qr_surface, (GDestroyNotify) cairo_surface_destroy);
+	context = gtk_widget_get_style_context(area);
 
-	return area;
+	provider = gtk_css_provider_new();
+	gtk_css_provider_load_from_string(provider, "* {background: white;}");
+	gtk_style_context_add_provider(context, GTK_STYLE_PROVIDER(provider), GTK_STYLE_PROVIDER_PRIORITY_USER + 1);
+	g_object_unref(provider);
     }
+
+    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(area), (GtkDrawingAreaDrawFunc) qrcode_draw, NULL, NULL);
+
+    {
+	GTask *task;
+
+	task = g_task_new(area, NULL, (GAsyncReadyCallback) qrcode_encode_callback, NULL);
+	g_task_set_task_data(task, g_strdup(uri), g_free);
+	g_task_run_in_thread(task, (GTaskThreadFunc) qrcode_encode_thread);
+	g_object_unref(task);
+    }
+
+    return area;
 }
 
 void dpp_qrcode_add(DPP *dpp) {
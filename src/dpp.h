@@ -33,7 +33,9 @@ struct DPP_s {
     GtkWidget *qrcode;
 };
 
-void qrcode_draw(GtkDrawingArea *area, cairo_t *cr, int width, int height, cairo_surface_t *qr_surface);
+void qrcode_draw(GtkDrawingArea *area, cairo_t *cr, int width, int height, gpointer user_data);
+void qrcode_encode_thread(GTask *task, GtkWidget *area, const gchar *uri, GCancellable *cancellable);
+void qrcode_encode_callback(GtkWidget *area, GAsyncResult *res, gpointer user_data);
 GtkWidget* qrcode_widget_new(const gchar *uri);
 void dpp_qrcode_add(DPP *dpp);
 
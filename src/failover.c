@@ -0,0 +1,405 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+static void failover_free(Failover *failover) {
+    failover_wait_stop(failover);
+
+    for (guint i = 0; i < failover->candidates->len; i ++) {
+	g_object_unref(g_array_index(failover->candidates, FailoverCandidate, i).network_proxy);
+    }
+
+    g_array_free(failover->candidates, TRUE);
+    g_object_unref(failover->cancellable);
+    g_object_unref(failover->station_proxy);
+    g_free(failover->ssid_failed);
+    g_free(failover);
+}
+
+static gint failover_candidate_compare(const FailoverCandidate *a, const FailoverCandidate *b) {
+    if (a->score > b->score) {
+	return -1;
+    }
+    else if (a->score < b->score) {
+	return 1;
+    }
+    else {
+	return 0;
+    }
+}
+
+/*
+ * A network is a candidate if it's known, and the user has allowed iwd to connect
+ * to it automatically.
+ */
+static gboolean failover_network_eligible(GDBusProxy *network_proxy) {
+    GVariant *known_network_var;
+    GDBusProxy *known_network_proxy;
+    gboolean eligible;
+
+    known_network_var = g_dbus_proxy_get_cached_property(network_proxy, "KnownNetwork");
+
+    if (known_network_var == NULL) {
+	return FALSE;
+    }
+
+    eligible = FALSE;
+    known_network_proxy = G_DBUS_PROXY(g_dbus_object_manager_get_interface(global.manager, g_variant_get_string(known_network_var, NULL), IWD_IFACE_KNOWN_NETWORK));
+    g_variant_unref(known_network_var);
+
+    if (known_network_proxy != NULL) {
+	GVariant *autoconnect_var;
+
+	autoconnect_var = g_dbus_proxy_get_cached_property(known_network_proxy, "AutoConnect");
+
+	if (autoconnect_var != NULL) {
+	    eligible = g_variant_get_boolean(autoconnect_var);
+	    g_variant_unref(autoconnect_var);
+	}
+
+	g_object_unref(known_network_proxy);
+    }
+
+    return eligible;
+}
+
+/*
+ * Ranks a network by its signal level, weighted by the fraction of past connection
+ * attempts which succeeded.
+ */
+static gdouble failover_network_score(const Network *network) {
+    GVariant *name_var, *type_var;
+    gchar *key;
+    gdouble signal, score;
+
+    if (network->level == SIGNAL_LEVEL_UNKNOWN) {
+	signal = 0.5 / (signal_config.n_thresholds + 1);
+    }
+    else {
+	signal = (gdouble) (signal_config.n_thresholds + 1 - network->level) / (signal_config.n_thresholds + 1);
+    }
+
+    name_var = g_dbus_proxy_get_cached_property(network->proxy, "Name");
+    type_var = g_dbus_proxy_get_cached_property(network->proxy, "Type");
+
+    if (name_var != NULL && type_var != NULL) {
+	key = connect_latency_key(g_variant_get_string(name_var, NULL), g_variant_get_string(type_var, NULL));
+	score = signal * connect_latency_success_rate(key);
+	g_free(key);
+    }
+    else {
+	// The success rate of a network without any history
+	score = signal * 0.5;
+    }
+
+    if (name_var != NULL) {
+	g_variant_unref(name_var);
+    }
+
+    if (type_var != NULL) {
+	g_variant_unref(type_var);
+    }
+
+    return score;
+}
+
+/*
+ * Connections which failed because the network couldn't be reached, rather than
+ * because of the user or the state of the device, trigger a failover.
+ */
+gboolean failover_eligible(const GError *err) {
+    return
+	g_error_matches(err, global.iwd_error_domain, IWD_ERROR_FAILED) ||
+	g_error_matches(err, global.iwd_error_domain, IWD_ERROR_TIMEOUT) ||
+	g_error_matches(err, global.iwd_error_domain, IWD_ERROR_NOT_FOUND) ||
+	g_error_matches(err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT) ||
+	g_error_matches(err, G_DBUS_ERROR, G_DBUS_ERROR_NO_REPLY) ||
+	g_error_matches(err, G_DBUS_ERROR, G_DBUS_ERROR_TIMEOUT);
+}
+
+/*
+ * Collects the candidates from the window's list of the station's networks, which
+ * is in the order given by iwd.
+ */
+void failover_start(GDBusProxy *network_proxy) {
+    Failover *failover;
+    Station *station;
+    const gchar *network_path;
+
+    failover_cancel();
+
+    if (global.window == NULL) {
+	return;
+    }
+
+    station = NULL;
+
+    {
+	GVariant *device_var;
+	const gchar *device_path;
+
+	device_var = g_dbus_proxy_get_cached_property(network_proxy, "Device");
+	device_path = g_variant_get_string(device_var, NULL);
+
+	for (ObjectList *list = global.window->objects[OBJECT_STATION]; list != NULL; list = list->next) {
+	    if (!strcmp(g_dbus_proxy_get_object_path(((Station *) list->data)->proxy), device_path)) {
+		station = (Station *) list->data;
+		break;
+	    }
+	}
+
+	g_variant_unref(device_var);
+    }
+
+    if (station == NULL) {
+	return;
+    }
+
+    failover = g_malloc(sizeof(Failover));
+    failover->station_proxy = g_object_ref(station->proxy);
+    failover->candidates = g_array_new(FALSE, FALSE, sizeof(FailoverCandidate));
+    failover->next = 0;
+    failover->cancellable = g_cancellable_new();
+    failover->handler_update = 0;
+    failover->wait_id = 0;
+
+    {
+	GVariant *name_var;
+
+	name_var = g_dbus_proxy_get_cached_property(network_proxy, "Name");
+	failover->ssid_failed = g_variant_dup_string(name_var, NULL);
+	g_variant_unref(name_var);
+    }
+
+    network_path = g_dbus_proxy_get_object_path(network_proxy);
+
+    for (gsize i = 0; i < station->n_networks; i ++) {
+	Network *network;
+
+	network = station->networks + i;
+
+	if (!strcmp(g_dbus_proxy_get_object_path(network->proxy), network_path) || !failover_network_eligible(network->proxy)) {
+	    continue;
+	}
+
+	g_array_append_val(failover->candidates, ((FailoverCandidate) {g_object_ref(network->proxy), failover_network_score(network)}));
+    }
+
+    // g_array_sort() isn't stable, but ties are rare enough not to matter
+    g_array_sort(failover->candidates, (GCompareFunc) failover_candidate_compare);
+
+    if (failover->candidates->len > FAILOVER_MAX_CANDIDATES) {
+	for (guint i = FAILOVER_MAX_CANDIDATES; i < failover->candidates->len; i ++) {
+	    g_object_unref(g_array_index(failover->candidates, FailoverCandidate, i).network_proxy);
+	}
+
+	g_array_set_size(failover->candidates, FAILOVER_MAX_CANDIDATES);
+    }
+
+    global.failover = failover;
+    failover_wait(failover);
+}
+
+/*
+ * Called when the user starts another connection attempt of their own.
+ */
+void failover_cancel() {
+    if (global.failover != NULL) {
+	g_cancellable_cancel(global.failover->cancellable);
+	failover_free(global.failover);
+	global.failover = NULL;
+    }
+}
+
+static gchar* failover_station_state(Failover *failover) {
+    GVariant *state_var;
+    gchar *state;
+
+    state_var = g_dbus_proxy_get_cached_property(failover->station_proxy, "State");
+
+    if (state_var == NULL) {
+	return NULL;
+    }
+
+    state = g_variant_dup_string(state_var, NULL);
+    g_variant_unref(state_var);
+    return state;
+}
+
+/*
+ * Whether iwd has connected to some network by itself. A state of "connecting" may
+ * be left over from the attempt which failed or timed out, so it doesn't count.
+ */
+static gboolean failover_state_busy(const gchar *state) {
+    return
+	state != NULL && (
+	    !strcmp(state, "connected") ||
+	    !strcmp(state, "roaming"));
+}
+
+/*
+ * Waits for the station to report that the failed attempt is over, or for
+ * FAILOVER_DISCONNECT_TIMEOUT to elapse, whichever comes first. An attempt which
+ * never left the "disconnected" state (e.g. NotFound) needs no wait.
+ */
+void failover_wait(Failover *failover) {
+    {
+	gchar *state;
+	gboolean disconnected;
+
+	state = failover_station_state(failover);
+	disconnected = state != NULL && !strcmp(state, "disconnected");
+	g_free(state);
+
+	if (disconnected) {
+	    failover_next(failover);
+	    return;
+	}
+    }
+
+    failover->handler_update = g_signal_connect_swapped(failover->station_proxy, "g-properties-changed", G_CALLBACK(failover_station_changed), failover);
+    failover->wait_id = g_timeout_add(FAILOVER_DISCONNECT_TIMEOUT, (GSourceFunc) failover_wait_timeout, failover);
+}
+
+void failover_wait_stop(Failover *failover) {
+    if (failover->handler_update != 0) {
+	g_signal_handler_disconnect(failover->station_proxy, failover->handler_update);
+	failover->handler_update = 0;
+    }
+
+    if (failover->wait_id != 0) {
+	g_source_remove(failover->wait_id);
+	failover->wait_id = 0;
+    }
+}
+
+/*
+ * A state of "connecting" may be left over from the failed attempt, so only
+ * "disconnected", "connected" and "roaming" end the wait early.
+ */
+void failover_station_changed(Failover *failover) {
+    gchar *state;
+
+    state = failover_station_state(failover);
+
+    if (state == NULL) {
+	return;
+    }
+
+    if (!strcmp(state, "disconnected")) {
+	failover_wait_stop(failover);
+	failover_next(failover);
+    }
+    else if (failover_state_busy(state)) {
+	failover_cancel();
+    }
+
+    g_free(state);
+}
+
+gboolean failover_wait_timeout(Failover *failover) {
+    failover->wait_id = 0;
+    failover_wait_stop(failover);
+    failover_next(failover);
+    return G_SOURCE_REMOVE;
+}
+
+/*
+ * Tries the next candidate, unless iwd has meanwhile found a network by itself.
+ */
+void failover_next(Failover *failover) {
+    GDBusProxy *network_proxy;
+
+    {
+	gchar *state;
+	gboolean busy;
+
+	state = failover_station_state(failover);
+	busy = failover_state_busy(state);
+	g_free(state);
+
+	if (busy) {
+	    failover_cancel();
+	    return;
+	}
+    }
+
+    if (failover->next == failover->candidates->len) {
+	gchar *message;
+
+	if (failover->candidates->len > 0) {
+	    message = g_strdup_printf(_("Failed to connect to %s, and no other known network could be reached"), failover->ssid_failed);
+	    send_notification(message);
+	    g_free(message);
+	}
+
+	failover_cancel();
+	return;
+    }
+
+    network_proxy = g_array_index(failover->candidates, FailoverCandidate, failover->next ++).network_proxy;
+    connect_latency_begin(network_proxy);
+
+    g_dbus_proxy_call(
+	network_proxy,
+	"Connect",
+	NULL,
+	G_DBUS_CALL_FLAGS_NONE,
+	FAILOVER_CONNECT_TIMEOUT,
+	failover->cancellable,
+	(GAsyncReadyCallback) failover_connect_callback,
+	failover);
+}
+
+/*
+ * A canceled call means that the failover has already been freed.
+ */
+void failover_connect_callback(GDBusProxy *network_proxy, GAsyncResult *res, Failover *failover) {
+    GVariant *ret;
+    GError *err;
+
+    err = NULL;
+    ret = g_dbus_proxy_call_finish(network_proxy, res, &err);
+    connect_latency_end(g_dbus_proxy_get_object_path(network_proxy), err);
+
+    if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+	g_error_free(err);
+	return;
+    }
+
+    if (ret != NULL) {
+	GVariant *name_var;
+	gchar *message;
+
+	name_var = g_dbus_proxy_get_cached_property(network_proxy, "Name");
+	message = g_strdup_printf(_("Failed to connect to %s; connected to %s instead"), failover->ssid_failed, g_variant_get_string(name_var, NULL));
+	send_notification(message);
+	g_free(message);
+	g_variant_unref(name_var);
+
+	g_variant_unref(ret);
+	failover_cancel();
+    }
+    else {
+	g_printerr("Failover to %s failed: %s\n", g_dbus_proxy_get_object_path(network_proxy), err->message);
+	g_error_free(err);
+	failover_wait(failover);
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_FAILOVER_H
+#define _IWGTK_FAILOVER_H
+
+#define FAILOVER_CONNECT_TIMEOUT 15000
+#define FAILOVER_DISCONNECT_TIMEOUT 3000
+#define FAILOVER_MAX_CANDIDATES 3
+
+typedef struct Failover_s Failover;
+typedef struct FailoverCandidate_s FailoverCandidate;
+
+/*
+ * After a connection attempt which the user started has failed, the other known
+ * networks in the station's scan results are tried in turn, best first.
+ *
+ * iwd replies to Connect before it reports the station as disconnected, so each
+ * attempt waits for that report (handler_update and wait_id) before it's made.
+ */
+struct Failover_s {
+    GDBusProxy *station_proxy;
+    gchar *ssid_failed;
+    GArray *candidates;
+    guint next;
+    GCancellable *cancellable;
+
+    gulong handler_update;
+    guint wait_id;
+};
+
+struct FailoverCandidate_s {
+    GDBusProxy *network_proxy;
+    gdouble score;
+};
+
+gboolean failover_eligible(const GError *err);
+void failover_start(GDBusProxy *network_proxy);
+void failover_cancel();
+void failover_wait(Failover *failover);
+void failover_wait_stop(Failover *failover);
+void failover_station_changed(Failover *failover);
+gboolean failover_wait_timeout(Failover *failover);
+void failover_next(Failover *failover);
+void failover_connect_callback(GDBusProxy *network_proxy, GAsyncResult *res, Failover *failover);
+
+#endif
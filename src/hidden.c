@@ -86,7 +86,7 @@ void station_add_hidden_network(Station *station, const gchar *address, const gc
     {
 	const gchar *icon_name;
 
-	icon_name = station_icons[get_signal_level(signal_strength)];
+	icon_name = signal_level_icon(signal_level_get(signal_strength));
 	symbolic_icon_set_image(icon_name, &colors.network_hidden, status_icon);
     }
 
@@ -98,7 +98,7 @@ void station_add_hidden_network(Station *station, const gchar *address, const gc
 
     gtk_grid_attach(GTK_GRID(station->network_table), status_icon,    0, index, 1, 1);
     gtk_grid_attach(GTK_GRID(station->network_table), address_label,  1, index, 1, 1);
-    gtk_grid_attach(GTK_GRID(station->network_table), security_label, 2, index, 1, 1);
+    gtk_grid_attach(GTK_GRID(station->network_table), security_label, 3, index, 1, 1);
 
     gtk_widget_set_halign(status_icon,    GTK_ALIGN_START);
     gtk_widget_set_halign(address_label,  GTK_ALIGN_START);
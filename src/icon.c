@@ -54,7 +54,12 @@ ColorTable colors = {
  * Signal thresholds are in dBm.
  */
 
-const gint16 signal_thresholds[] = {-60, -67, -74, -81};
+guint64 icons_rendered = 0;
+
+/*
+ * Rendered indicator icons, keyed by icon name and color.
+ */
+static GHashTable *icon_cache = NULL;
 
 const gchar* station_icons[] = {
     ICON_STATION_0,
@@ -103,16 +108,12 @@ void icon_theme_set() {
     }
 }
 
-gint8 get_signal_level(gint16 signal_strength) {
-    gint8 i;
-
-    for (i = 0; i < N_SIGNAL_THRESHOLDS; i ++) {
-	if (signal_strength > 100*signal_thresholds[i]) {
-	    return i;
-	}
+gboolean icon_theme_set_idle() {
+    if (global.theme == NULL) {
+	icon_theme_set();
     }
 
-    return N_SIGNAL_THRESHOLDS;
+    return G_SOURCE_REMOVE;
 }
 
 GtkSnapshot* symbolic_icon_get_snapshot(const gchar *icon_name, const GdkRGBA *icon_color) {
@@ -130,6 +131,7 @@ GtkSnapshot* symbolic_icon_get_snapshot(const gchar *icon_name, const GdkRGBA *i
     );
 
     snapshot = gtk_snapshot_new();
+    icons_rendered ++;
 
     gtk_symbolic_paintable_snapshot_symbolic(
 	GTK_SYMBOLIC_PAINTABLE(icon),
@@ -175,3 +177,324 @@ cairo_surface_t* symbolic_icon_get_surface(const gchar *icon_name, const GdkRGBA
 
     return surface;
 }
+
+static gchar* symbolic_icon_key(const gchar *icon_name, const GdkRGBA *icon_color) {
+    return g_strdup_printf("%s #%02x%02x%02x%02x", icon_name,
+	(guint) (icon_color->red*0xff), (guint) (icon_color->green*0xff),
+	(guint) (icon_color->blue*0xff), (guint) (icon_color->alpha*0xff));
+}
+
+/*
+ * Returns a surface without rendering anything, either from the pre-rendered atlas
+ * or from the cache of icons rendered earlier. Returns NULL if the icon has yet to be
+ * rendered.
+ */
+cairo_surface_t* symbolic_icon_lookup(const gchar *icon_name, const GdkRGBA *icon_color) {
+    cairo_surface_t *surface;
+    gchar *key;
+
+#ifdef ICON_ATLAS
+    surface = icon_atlas_get_surface(icon_name, icon_color);
+
+    if (surface != NULL) {
+	return surface;
+    }
+#endif
+
+    if (icon_cache == NULL) {
+	return NULL;
+    }
+
+    key = symbolic_icon_key(icon_name, icon_color);
+    surface = g_hash_table_lookup(icon_cache, key);
+    g_free(key);
+
+    return surface ? cairo_surface_reference(surface) : NULL;
+}
+
+void icon_request_free(IconRequest *request) {
+    g_free(request->key);
+    g_object_unref(request->file);
+    g_free(request);
+}
+
+/*
+ * Fills the icon's alpha mask with a single color. This matches what GTK does for
+ * single-color symbolic icons.
+ */
+cairo_surface_t* symbolic_icon_colorize(GdkPixbuf *pixbuf, const GdkRGBA *icon_color) {
+    if (!gdk_pixbuf_get_has_alpha(pixbuf)) {
+	g_printerr("Symbolic icon has no alpha channel\n");
+	return cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 32, 32);
+    }
+
+    return symbolic_icon_fill_mask(
+	gdk_pixbuf_read_pixels(pixbuf) + 3,
+	MIN(gdk_pixbuf_get_width(pixbuf), 32),
+	MIN(gdk_pixbuf_get_height(pixbuf), 32),
+	gdk_pixbuf_get_rowstride(pixbuf),
+	gdk_pixbuf_get_n_channels(pixbuf),
+	icon_color);
+}
+
+/*
+ * Fills an 8-bit alpha mask with a single color, producing a 32x32 ARGB32 surface
+ * with the mask centered on it. pixel_stride is the distance between consecutive
+ * alpha values in a row.
+ */
+cairo_surface_t* symbolic_icon_fill_mask(const guchar *alpha, int width, int height, int rowstride, int pixel_stride, const GdkRGBA *icon_color) {
+    cairo_surface_t *surface;
+    guint32 *argb;
+    int stride_n, x0, y0;
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 32, 32);
+    stride_n = cairo_image_surface_get_stride(surface) / 4;
+    argb = (guint32 *) cairo_image_surface_get_data(surface);
+    cairo_surface_flush(surface);
+
+    x0 = (32 - width) / 2;
+    y0 = (32 - height) / 2;
+
+    for (int i = 0; i < height; i ++) {
+	for (int j = 0; j < width; j ++) {
+	    guint32 a, r, g, b;
+
+	    a = alpha[i*rowstride + j*pixel_stride] * icon_color->alpha;
+	    r = a * icon_color->red;
+	    g = a * icon_color->green;
+	    b = a * icon_color->blue;
+
+	    argb[(y0 + i)*stride_n + x0 + j] = (a << 24) | (r << 16) | (g << 8) | b;
+	}
+    }
+
+    cairo_surface_mark_dirty(surface);
+    return surface;
+}
+
+#ifdef ICON_ATLAS
+/*
+ * Pre-rendered icons, compiled in at build time. See icons/icon-atlas.c for the
+ * format.
+ */
+static GVariant *icon_atlas = NULL;
+
+static gboolean icon_atlas_load() {
+    GBytes *bytes;
+    GVariant *atlas;
+
+    if (icon_atlas != NULL) {
+	return TRUE;
+    }
+
+    bytes = g_resources_lookup_data(ICON_ATLAS_RESOURCE, G_RESOURCE_LOOKUP_FLAGS_NONE, NULL);
+
+    if (bytes == NULL) {
+	return FALSE;
+    }
+
+    atlas = g_variant_new_from_bytes(G_VARIANT_TYPE(ICON_ATLAS_TYPE), bytes, TRUE);
+    g_variant_ref_sink(atlas);
+    g_bytes_unref(bytes);
+
+    if (G_BYTE_ORDER == G_BIG_ENDIAN) {
+	icon_atlas = g_variant_byteswap(atlas);
+	g_variant_unref(atlas);
+    }
+    else {
+	icon_atlas = atlas;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Returns NULL if the icon isn't in the atlas.
+ */
+cairo_surface_t* icon_atlas_get_surface(const gchar *icon_name, const GdkRGBA *icon_color) {
+    GVariant *entries, *data_var;
+    guint16 atlas_width, x, y, width, height;
+    const guchar *data;
+    gsize n;
+    gboolean found;
+
+    if (!icon_atlas_load()) {
+	return NULL;
+    }
+
+    g_variant_get_child(icon_atlas, 0, "q", &atlas_width);
+    entries = g_variant_get_child_value(icon_atlas, 2);
+    found = g_variant_lookup(entries, icon_name, "(qqqq)", &x, &y, &width, &height);
+    g_variant_unref(entries);
+
+    if (!found) {
+	return NULL;
+    }
+
+    data_var = g_variant_get_child_value(icon_atlas, 3);
+    data = g_variant_get_fixed_array(data_var, &n, 1);
+
+    if ((gsize) (y + height - 1)*atlas_width + x + width > n) {
+	g_printerr("Icon atlas entry '%s' is out of bounds\n", icon_name);
+	g_variant_unref(data_var);
+	return NULL;
+    }
+
+    icons_rendered ++;
+
+    {
+	cairo_surface_t *surface;
+
+	surface = symbolic_icon_fill_mask(data + y*atlas_width + x, MIN(width, 32), MIN(height, 32), atlas_width, 1, icon_color);
+	g_variant_unref(data_var);
+	return surface;
+    }
+}
+#endif
+
+void symbolic_icon_render_thread(GTask *task, gpointer source, IconRequest *request, GCancellable *cancellable) {
+    GInputStream *stream;
+    GdkPixbuf *pixbuf;
+    GError *err;
+
+    err = NULL;
+    stream = G_INPUT_STREAM(g_file_read(request->file, NULL, &err));
+
+    if (stream == NULL) {
+	g_task_return_error(task, err);
+	return;
+    }
+
+    pixbuf = gdk_pixbuf_new_from_stream_at_scale(stream, 32, 32, TRUE, NULL, &err);
+    g_object_unref(stream);
+
+    if (pixbuf == NULL) {
+	g_task_return_error(task, err);
+	return;
+    }
+
+    g_task_return_pointer(task, symbolic_icon_colorize(pixbuf, &request->color), (GDestroyNotify) cairo_surface_destroy);
+    g_object_unref(pixbuf);
+}
+
+/*
+ * Looks up a symbolic icon without GtkIconTheme, for the lightweight indicator
+ * daemon. Only the Adwaita and hicolor themes are searched.
+ */
+GFile* symbolic_icon_find_file(const gchar *icon_name) {
+    static const gchar *themes[] = {"Adwaita", "hicolor", NULL};
+    static const gchar *subdirs[] = {"symbolic/status", "scalable/status", NULL};
+    const gchar * const *data_dirs;
+    gchar *filename;
+    GFile *file;
+
+    filename = g_strconcat(icon_name, ".svg", NULL);
+    data_dirs = g_get_system_data_dirs();
+    file = NULL;
+
+    for (int i = -1; (i == -1 || data_dirs[i] != NULL) && file == NULL; i ++) {
+	const gchar *data_dir;
+
+	data_dir = (i == -1) ? g_get_user_data_dir() : data_dirs[i];
+
+	for (int j = 0; themes[j] != NULL && file == NULL; j ++) {
+	    for (int k = 0; subdirs[k] != NULL && file == NULL; k ++) {
+		gchar *path;
+
+		path = g_build_filename(data_dir, "icons", themes[j], subdirs[k], filename, NULL);
+
+		if (g_file_test(path, G_FILE_TEST_IS_REGULAR)) {
+		    file = g_file_new_for_path(path);
+		}
+
+		g_free(path);
+	    }
+	}
+    }
+
+    g_free(filename);
+    return file;
+}
+
+/*
+ * Renders an icon for the indicator on GLib's worker thread pool. The icon theme
+ * lookup happens on the calling thread, but loading and rasterizing the icon do not.
+ *
+ * The result is always delivered, even if the cancellable is triggered, so that it
+ * can be cached; callers must check the cancellable themselves.
+ */
+void symbolic_icon_get_surface_async(const gchar *icon_name, const GdkRGBA *icon_color, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data) {
+    GTask *task;
+    GtkIconPaintable *icon;
+    GFile *file;
+
+    task = g_task_new(NULL, cancellable, callback, user_data);
+    g_task_set_check_cancellable(task, FALSE);
+
+    if (global.theme != NULL) {
+	icon = gtk_icon_theme_lookup_icon(
+	    global.theme,
+	    icon_name,
+	    NULL,
+	    32,
+	    1,
+	    GTK_TEXT_DIR_NONE,
+	    GTK_ICON_LOOKUP_FORCE_SYMBOLIC
+	);
+
+	file = gtk_icon_paintable_get_file(icon);
+	g_object_unref(icon);
+    }
+    else {
+	file = symbolic_icon_find_file(icon_name);
+
+	if (file == NULL) {
+	    g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "Icon '%s' not found", icon_name);
+	    g_object_unref(task);
+	    return;
+	}
+    }
+
+    if (file == NULL) {
+	/*
+	 * The theme has given us a built-in fallback image, which can only be drawn
+	 * by GTK itself.
+	 */
+	g_task_return_pointer(task, symbolic_icon_get_surface(icon_name, icon_color), (GDestroyNotify) cairo_surface_destroy);
+    }
+    else {
+	IconRequest *request;
+
+	request = g_malloc(sizeof(IconRequest));
+	request->key = symbolic_icon_key(icon_name, icon_color);
+	request->file = file;
+	request->color = *icon_color;
+
+	g_task_set_task_data(task, request, (GDestroyNotify) icon_request_free);
+	g_task_run_in_thread(task, (GTaskThreadFunc) symbolic_icon_render_thread);
+    }
+
+    g_object_unref(task);
+}
+
+/*
+ * Returns a surface owned by the caller, or NULL if rendering has failed.
+ */
+cairo_surface_t* symbolic_icon_get_surface_finish(GAsyncResult *res, GError **err) {
+    cairo_surface_t *surface;
+    IconRequest *request;
+
+    surface = g_task_propagate_pointer(G_TASK(res), err);
+    request = g_task_get_task_data(G_TASK(res));
+
+    if (surface != NULL && request != NULL) {
+	if (icon_cache == NULL) {
+	    icon_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) cairo_surface_destroy);
+	}
+
+	g_hash_table_replace(icon_cache, g_strdup(request->key), cairo_surface_reference(surface));
+	icons_rendered ++;
+    }
+
+    return surface;
+}
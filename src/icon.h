@@ -21,6 +21,7 @@
 #define _IWGTK_ICON_H
 
 typedef struct ColorTable_s ColorTable;
+typedef struct IconRequest_s IconRequest;
 
 #define ICON_STATION_0       "network-wireless-signal-excellent-symbolic"
 #define ICON_STATION_1       "network-wireless-signal-good-symbolic"
@@ -38,7 +39,10 @@ typedef struct ColorTable_s ColorTable;
 #define ICON_DEVICE_DISABLED  "network-wireless-disabled-symbolic"
 #define ICON_ADAPTER_DISABLED "network-wireless-hardware-disabled-symbolic"
 
-#define N_SIGNAL_THRESHOLDS 4
+#define N_STATION_ICONS 5
+
+#define ICON_ATLAS_RESOURCE "/org/twosheds/iwgtk/icons.atlas"
+#define ICON_ATLAS_TYPE     "(qqa{s(qqqq)}ay)"
 
 struct ColorTable_s {
     GdkRGBA station_connected;
@@ -61,17 +65,35 @@ struct ColorTable_s {
     GdkRGBA network_hidden;
 };
 
+struct IconRequest_s {
+    gchar *key;
+    GFile *file;
+    GdkRGBA color;
+};
+
 extern ColorTable colors;
-extern const gint16 signal_thresholds[];
+extern guint64 icons_rendered;
 extern const gchar* station_icons[];
 
 extern const GdkRGBA *color_status[];
 
 void icon_theme_set();
-gint8 get_signal_level(gint16 signal_strength);
+gboolean icon_theme_set_idle();
 
 GtkSnapshot* symbolic_icon_get_snapshot(const gchar *icon_name, const GdkRGBA *icon_color);
 void symbolic_icon_set_image(const gchar *icon_name, const GdkRGBA *icon_color, GtkWidget *image);
 cairo_surface_t* symbolic_icon_get_surface(const gchar *icon_name, const GdkRGBA *icon_color);
 
+cairo_surface_t* symbolic_icon_lookup(const gchar *icon_name, const GdkRGBA *icon_color);
+void icon_request_free(IconRequest *request);
+cairo_surface_t* symbolic_icon_colorize(GdkPixbuf *pixbuf, const GdkRGBA *icon_color);
+cairo_surface_t* symbolic_icon_fill_mask(const guchar *alpha, int width, int height, int rowstride, int pixel_stride, const GdkRGBA *icon_color);
+#ifdef ICON_ATLAS
+cairo_surface_t* icon_atlas_get_surface(const gchar *icon_name, const GdkRGBA *icon_color);
+#endif
+void symbolic_icon_render_thread(GTask *task, gpointer source, IconRequest *request, GCancellable *cancellable);
+GFile* symbolic_icon_find_file(const gchar *icon_name);
+void symbolic_icon_get_surface_async(const gchar *icon_name, const GdkRGBA *icon_color, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data);
+cairo_surface_t* symbolic_icon_get_surface_finish(GAsyncResult *res, GError **err);
+
 #endif
@@ -19,72 +19,60 @@
 
 #include "iwgtk.h"
 
-GDBusArgInfo arg_device = {-1, "device", "o", NULL};
-GDBusArgInfo arg_level = {-1, "level", "y", NULL};
-
-GDBusInterfaceInfo signal_agent_interface_info = {
-    -1,
-    IWD_IFACE_SIGNAL_LEVEL_AGENT,
-    (GDBusMethodInfo *[]) {
-	&(GDBusMethodInfo) {
-	    -1,
-	    "Release",
-	    (GDBusArgInfo *[]) {&arg_device, NULL},
-	    NULL,
-	    NULL
-	},
-	&(GDBusMethodInfo) {
-	    -1,
-	    "Changed",
-	    (GDBusArgInfo *[]) {&arg_device, &arg_level, NULL},
-	    NULL,
-	    NULL
-	},
-	NULL
-    },
-    NULL, // Signal info
-    NULL, // Property info
-    NULL  // Annotation info
-};
-
-GDBusInterfaceVTable signal_agent_interface_vtable = {
-    (GDBusInterfaceMethodCallFunc) signal_agent_method_call_handler,
-    NULL,
-    NULL
-};
-
 Indicator* indicator_new(GDBusProxy *device_proxy) {
     Indicator *indicator;
-    GDBusObject *device_object;
     GDBusProxy *adapter_proxy;
 
-    indicator = g_malloc(sizeof(Indicator));
-    indicator->next = NULL;
-    indicator->update_mode_handler = 0;
-    indicator->signal_agent_id = 0;
-
-    device_object = g_dbus_interface_get_object(G_DBUS_INTERFACE(device_proxy));
-
-    indicator->sni = sni_new(device_object);
-    indicator->sni->context_menu_handler = (SNIActivateHandler) indicator_activate;
-    indicator->sni->activate_handler = (SNIActivateHandler) indicator_activate;
-    indicator->level = N_SIGNAL_THRESHOLDS + 1;
-
-    sni_category_set(indicator->sni, "Hardware");
-    sni_id_set(indicator->sni, APPLICATION_ID);
-    sni_status_set(indicator->sni, "Active");
-
     {
 	GVariant *adapter_path_var;
 	const gchar *adapter_path;
 
 	adapter_path_var = g_dbus_proxy_get_cached_property(device_proxy, "Adapter");
 	adapter_path = g_variant_get_string(adapter_path_var, NULL);
-	adapter_proxy = G_DBUS_PROXY(g_dbus_object_manager_get_interface(global.manager, adapter_path, IWD_IFACE_ADAPTER));
+	adapter_proxy = indicator_manager_get_interface(global.indicator_manager, adapter_path, IWD_IFACE_ADAPTER);
+
+	if (adapter_proxy == NULL) {
+	    g_printerr("Cannot create indicator: Adapter %s not found\n", adapter_path);
+	    g_variant_unref(adapter_path_var);
+	    return NULL;
+	}
+
 	g_variant_unref(adapter_path_var);
     }
 
-    indicator->device_proxy = device_proxy;
+    indicator = g_malloc(sizeof(Indicator));
+    indicator->next = NULL;
+    indicator->proxy = NULL;
+    indicator->update_mode_handler = 0;
+    indicator->set_mode = NULL;
+    indicator->cancellable = g_cancellable_new();
+    signal_filter_init(&indicator->signal, (SignalFilterCallback) indicator_signal_level_set, indicator);
+    indicator->rank = INDICATOR_RANK_DOWN;
+    indicator->title = NULL;
+    indicator->description = NULL;
+    indicator->network_path = NULL;
+    indicator->ssid = NULL;
+    indicator->ssid_cancellable = NULL;
+    indicator->link_state = NULL;
+    indicator->poll_id = 0;
+    indicator->details = NULL;
+    indicator->throughput_interface = NULL;
+    indicator->throughput = NULL;
+    indicator->tooltip_source = 0;
+    indicator->tooltip_pending = FALSE;
+    indicator->icon_name = NULL;
+    indicator->icon_color = NULL;
+
+    /*
+     * In single-icon mode, the indicator has no tray icon of its own and only
+     * feeds the summary.
+     */
+    indicator->sni = NULL;
+    if (!global.indicator_single_icon) {
+	indicator_sni_new(indicator);
+    }
+
+    indicator->device_proxy = g_object_ref(device_proxy);
     indicator->adapter_proxy = adapter_proxy;
 
     indicator->update_device_handler = g_signal_connect_swapped(device_proxy, "g-properties-changed", G_CALLBACK(indicator_set_device), indicator);
@@ -95,57 +83,509 @@ Indicator* indicator_new(GDBusProxy *device_proxy) {
     return indicator;
 }
 
+void indicator_sni_new(Indicator *indicator) {
+    indicator->sni = sni_new(indicator);
+    indicator->sni->context_menu_handler = (SNIActivateHandler) indicator_activate;
+    indicator->sni->activate_handler = (SNIActivateHandler) indicator_activate;
+
+    sni_category_set(indicator->sni, "Hardware");
+    sni_id_set(indicator->sni, APPLICATION_ID);
+    sni_status_set(indicator->sni, "Active");
+}
+
 void indicator_rm(Indicator *indicator) {
-    if (indicator->signal_agent_id != 0) {
-	g_dbus_connection_unregister_object(g_dbus_proxy_get_connection(indicator->proxy), indicator->signal_agent_id);
+    indicator_mode_rm(indicator);
+
+    if (indicator->tooltip_source != 0) {
+	g_source_remove(indicator->tooltip_source);
     }
 
-    sni_rm(indicator->sni);
+    g_cancellable_cancel(indicator->cancellable);
+    g_object_unref(indicator->cancellable);
+
+    if (indicator->sni != NULL) {
+	sni_rm(indicator->sni);
+    }
+    else if (global.indicator_summary != NULL) {
+	indicator_summary_schedule();
+    }
 
     g_signal_handler_disconnect(indicator->device_proxy, indicator->update_device_handler);
     g_signal_handler_disconnect(indicator->adapter_proxy, indicator->update_adapter_handler);
 
-    if (indicator->update_mode_handler != 0) {
+    g_object_unref(indicator->device_proxy);
+    g_object_unref(indicator->adapter_proxy);
+
+    g_free(indicator->title);
+    g_free(indicator->description);
+    g_free(indicator->details);
+    g_free(indicator->throughput);
+    g_free(indicator);
+}
+
+/*
+ * Detaches the indicator from its station, access point or ad-hoc interface.
+ */
+void indicator_mode_rm(Indicator *indicator) {
+    signal_filter_clear(&indicator->signal);
+    indicator_poll_stop(indicator);
+    indicator_throughput_stop(indicator);
+    indicator->link_state = NULL;
+
+    if (indicator->ssid_cancellable != NULL) {
+	g_cancellable_cancel(indicator->ssid_cancellable);
+	g_object_unref(indicator->ssid_cancellable);
+	indicator->ssid_cancellable = NULL;
+    }
+
+    g_free(indicator->network_path);
+    g_free(indicator->ssid);
+    indicator->network_path = NULL;
+    indicator->ssid = NULL;
+
+    if (indicator->proxy != NULL) {
+	if (indicator->set_mode == indicator_set_station) {
+	    signal_agent_unsubscribe(g_dbus_proxy_get_object_path(indicator->proxy), (SignalAgentCallback) indicator_signal_agent_changed, indicator);
+	}
+
 	g_signal_handler_disconnect(indicator->proxy, indicator->update_mode_handler);
+	g_object_unref(indicator->proxy);
+	indicator->proxy = NULL;
+	indicator->update_mode_handler = 0;
+	indicator->set_mode = NULL;
     }
+}
 
-    g_free(indicator);
+/*
+ * Called by the indicator manager whenever one of the interfaces it tracks appears.
+ */
+void indicator_interface_add(GDBusProxy *proxy, ObjectType type) {
+    Indicator *indicator;
+    IndicatorSetter indicator_set_mode;
+    const gchar *path;
+
+    path = g_dbus_proxy_get_object_path(proxy);
+    indicator = g_hash_table_lookup(global.indicator_manager->indicators, path);
+
+    if (indicator == NULL) {
+	if (type == OBJECT_DEVICE) {
+	    indicator = indicator_new(proxy);
+
+	    if (indicator != NULL) {
+		Indicator **tail;
+
+		tail = &global.indicators;
+		while (*tail != NULL) {
+		    tail = &(*tail)->next;
+		}
+
+		*tail = indicator;
+		g_hash_table_insert(global.indicator_manager->indicators, g_strdup(path), indicator);
+	    }
+	}
+
+	return;
+    }
+
+    indicator_set_mode = NULL;
+
+    switch (type) {
+	case OBJECT_STATION:
+	    indicator_set_mode = indicator_set_station;
+	    break;
+	case OBJECT_ACCESS_POINT:
+	    indicator_set_mode = indicator_set_ap;
+	    break;
+	case OBJECT_ADHOC:
+	    indicator_set_mode = indicator_set_adhoc;
+	    break;
+	default:
+	    break;
+    }
+
+    if (indicator_set_mode != NULL) {
+	// Never bound to two interfaces at once
+	if (indicator->proxy != NULL) {
+	    indicator_mode_rm(indicator);
+	}
+
+	indicator->proxy = g_object_ref(proxy);
+	indicator->set_mode = indicator_set_mode;
+	indicator->update_mode_handler = g_signal_connect_swapped(proxy, "g-properties-changed", G_CALLBACK(indicator_set_mode), indicator);
+	indicator_set_mode(indicator);
+
+	if (type == OBJECT_STATION) {
+	    signal_agent_subscribe(proxy, (SignalAgentCallback) indicator_signal_agent_changed, indicator);
+	}
+    }
 }
 
-void indicator_station_init_signal_agent(Indicator *indicator, GDBusProxy *station_proxy) {
-    GError *err;
+void indicator_interface_rm(GDBusProxy *proxy, ObjectType type) {
+    Indicator *indicator;
     const gchar *path;
-    GVariant *levels;
-    static const gchar *agent_error_msg = "Failed to register signal level agent: %s\n";
 
-    path = g_dbus_proxy_get_object_path(station_proxy);
+    path = g_dbus_proxy_get_object_path(proxy);
+    indicator = g_hash_table_lookup(global.indicator_manager->indicators, path);
+
+    if (indicator == NULL) {
+	return;
+    }
+
+    if (proxy == indicator->device_proxy) {
+	// The indicator's device has been taken down; delete the indicator
+
+	Indicator **link;
+
+	g_hash_table_remove(global.indicator_manager->indicators, path);
+
+	link = &global.indicators;
+	while (*link != indicator) {
+	    link = &(*link)->next;
+	}
+
+	*link = indicator->next;
+	indicator_rm(indicator);
+    }
+    else if (proxy == indicator->proxy) {
+	// The indicator's mode has changed, or it has been powered down
+	indicator_mode_rm(indicator);
+    }
+}
+
+void indicator_signal_agent_changed(guint8 level_min, guint8 level_max, Indicator *indicator) {
+    signal_filter_update(&indicator->signal, level_min, level_max);
+}
+
+/*
+ * Sets a tray icon. Icons which haven't been rendered yet are rendered on a worker
+ * thread, and the previous icon stays in place until the new one is ready.
+ */
+void tray_icon_set(StatusNotifierItem *sni, const gchar *icon_name, const GdkRGBA *icon_color) {
+    cairo_surface_t *surface;
+
+    if (sni->icon_cancellable != NULL) {
+	g_cancellable_cancel(sni->icon_cancellable);
+	g_object_unref(sni->icon_cancellable);
+	sni->icon_cancellable = NULL;
+    }
+
+    surface = symbolic_icon_lookup(icon_name, icon_color);
+
+    if (surface != NULL) {
+	sni_icon_pixmap_set(sni, surface);
+	return;
+    }
+
+    sni->icon_cancellable = g_cancellable_new();
+    symbolic_icon_get_surface_async(icon_name, icon_color, sni->icon_cancellable, (GAsyncReadyCallback) tray_icon_ready, sni);
+}
+
+void tray_icon_ready(GObject *source, GAsyncResult *res, StatusNotifierItem *sni) {
+    cairo_surface_t *surface;
+    GError *err;
 
     err = NULL;
-    indicator->signal_agent_id = g_dbus_connection_register_object(
-	g_dbus_proxy_get_connection(station_proxy),
-	path,
-	&signal_agent_interface_info,
-	&signal_agent_interface_vtable,
-	indicator,
-	NULL,
-	&err);
+    surface = symbolic_icon_get_surface_finish(res, &err);
+
+    /*
+     * If the request has been superseded, the tray icon may no longer exist.
+     */
+    if (g_cancellable_is_cancelled(g_task_get_cancellable(G_TASK(res)))) {
+	if (surface != NULL) {
+	    cairo_surface_destroy(surface);
+	}
+	else {
+	    g_error_free(err);
+	}
+	return;
+    }
 
-    if (err != NULL) {
-	g_printerr(agent_error_msg, err->message);
+    g_object_unref(sni->icon_cancellable);
+    sni->icon_cancellable = NULL;
+
+    if (surface == NULL) {
+	g_printerr("Failed to render indicator icon: %s\n", err->message);
 	g_error_free(err);
 	return;
     }
 
-    levels = g_variant_new_fixed_array(G_VARIANT_TYPE_INT16, signal_thresholds, N_SIGNAL_THRESHOLDS, sizeof(gint16));
-    g_dbus_proxy_call(
-	station_proxy,
-	"RegisterSignalLevelAgent",
-	g_variant_new("(o@an)", path, levels),
-	G_DBUS_CALL_FLAGS_NONE,
-	-1,
-	NULL,
-	(GAsyncReadyCallback) method_call_log,
-	(gpointer) agent_error_msg);
+    sni_icon_pixmap_set(sni, surface);
+}
+
+void indicator_icon_set(Indicator *indicator, const gchar *icon_name, const GdkRGBA *icon_color) {
+    indicator->icon_name = icon_name;
+    indicator->icon_color = icon_color;
+
+    if (indicator->sni != NULL) {
+	tray_icon_set(indicator->sni, icon_name, icon_color);
+    }
+    else {
+	indicator_summary_schedule();
+    }
+}
+
+void indicator_title_set(Indicator *indicator, const gchar *title) {
+    g_free(indicator->title);
+    indicator->title = g_strdup(title);
+
+    if (indicator->sni != NULL) {
+	sni_title_set(indicator->sni, title);
+    }
+    else {
+	indicator_summary_schedule();
+    }
+
+    indicator_tooltip_schedule(indicator);
+}
+
+/*
+ * The tooltip is refreshed at most once every tooltip-interval seconds, independently
+ * of the icon: the first change is shown immediately, and any further changes within
+ * the interval are coalesced into a single update at its end.
+ */
+void indicator_tooltip_schedule(Indicator *indicator) {
+    if (indicator->tooltip_source != 0) {
+	indicator->tooltip_pending = TRUE;
+	return;
+    }
+
+    indicator_tooltip_update(indicator);
+    indicator->tooltip_source = g_timeout_add_seconds(
+	global.indicator_tooltip_interval > 0 ? global.indicator_tooltip_interval : INDICATOR_TOOLTIP_INTERVAL_DEFAULT,
+	(GSourceFunc) indicator_tooltip_timeout,
+	indicator);
+}
+
+gboolean indicator_tooltip_timeout(Indicator *indicator) {
+    if (indicator->tooltip_pending) {
+	indicator->tooltip_pending = FALSE;
+	indicator_tooltip_update(indicator);
+	return G_SOURCE_CONTINUE;
+    }
+
+    indicator->tooltip_source = 0;
+    return G_SOURCE_REMOVE;
+}
+
+/*
+ * Composes the description, below the title, from the link state, the details
+ * last retrieved from the diagnostics interface, and the throughput. The tooltip
+ * is only replaced if its text has changed.
+ */
+void indicator_tooltip_update(Indicator *indicator) {
+    GString *description;
+
+    description = g_string_new(NULL);
+
+    if (indicator->link_state != NULL) {
+	g_string_append_printf(description, _("Link: %s"), indicator->link_state);
+    }
+
+    if (indicator->details != NULL) {
+	if (description->len > 0) {
+	    g_string_append_c(description, '\n');
+	}
+
+	g_string_append(description, indicator->details);
+    }
+
+    if (indicator->throughput != NULL) {
+	if (description->len > 0) {
+	    g_string_append_c(description, '\n');
+	}
+
+	g_string_append(description, indicator->throughput);
+    }
+
+    if (g_strcmp0(description->str, indicator->description ? indicator->description : "") != 0) {
+	g_free(indicator->description);
+	indicator->description = description->len > 0 ? g_strdup(description->str) : NULL;
+
+	if (indicator->sni == NULL) {
+	    indicator_summary_schedule();
+	}
+    }
+
+    if (indicator->sni != NULL) {
+	sni_tooltip_set(indicator->sni, indicator->title ? indicator->title : "", description->str);
+    }
+
+    g_string_free(description, TRUE);
+}
+
+IndicatorSummary* indicator_summary_new() {
+    IndicatorSummary *summary;
+
+    summary = g_malloc(sizeof(IndicatorSummary));
+    summary->update_source = 0;
+    summary->title = NULL;
+    summary->description = NULL;
+    summary->icon_name = NULL;
+    summary->icon_color = NULL;
+
+    summary->sni = sni_new(summary);
+    summary->sni->context_menu_handler = (SNIActivateHandler) indicator_summary_activate;
+    summary->sni->activate_handler = (SNIActivateHandler) indicator_summary_activate;
+
+    sni_category_set(summary->sni, "Hardware");
+    sni_id_set(summary->sni, APPLICATION_ID);
+    sni_status_set(summary->sni, "Active");
+
+    return summary;
+}
+
+void indicator_summary_free(IndicatorSummary *summary) {
+    if (summary->update_source != 0) {
+	g_source_remove(summary->update_source);
+    }
+
+    sni_rm(summary->sni);
+    g_free(summary->title);
+    g_free(summary->description);
+    g_free(summary);
+}
+
+/*
+ * Changes to any number of indicators are coalesced into a single update of the
+ * summary, so the tray traffic doesn't grow with the number of devices.
+ */
+void indicator_summary_schedule() {
+    if (global.indicator_summary == NULL) {
+	global.indicator_summary = indicator_summary_new();
+    }
+
+    if (global.indicator_summary->update_source == 0) {
+	global.indicator_summary->update_source = g_idle_add((GSourceFunc) indicator_summary_update, global.indicator_summary);
+    }
+}
+
+static gboolean indicator_better(const Indicator *a, const Indicator *b) {
+    if (a->rank != b->rank) {
+	return a->rank > b->rank;
+    }
+
+    return a->signal.level < b->signal.level;
+}
+
+gboolean indicator_summary_update(IndicatorSummary *summary) {
+    Indicator *best;
+    GString *description;
+    gboolean tooltip_changed;
+
+    summary->update_source = 0;
+
+    if (global.indicators == NULL) {
+	indicator_summary_free(summary);
+	global.indicator_summary = NULL;
+	return G_SOURCE_REMOVE;
+    }
+
+    best = NULL;
+    description = g_string_new(NULL);
+
+    for (Indicator *indicator = global.indicators; indicator != NULL; indicator = indicator->next) {
+	GVariant *name_var;
+
+	if (best == NULL || indicator_better(indicator, best)) {
+	    best = indicator;
+	}
+
+	if (description->len > 0) {
+	    g_string_append_c(description, '\n');
+	}
+
+	name_var = g_dbus_proxy_get_cached_property(indicator->device_proxy, "Name");
+	g_string_append_printf(description, "%s: %s",
+	    name_var ? g_variant_get_string(name_var, NULL) : g_dbus_proxy_get_object_path(indicator->device_proxy),
+	    indicator->title ? indicator->title : "");
+
+	if (indicator->description) {
+	    g_string_append_printf(description, "\n%s", indicator->description);
+	}
+
+	if (name_var) {
+	    g_variant_unref(name_var);
+	}
+    }
+
+    tooltip_changed = FALSE;
+
+    if (best->title != NULL && g_strcmp0(best->title, summary->title) != 0) {
+	g_free(summary->title);
+	summary->title = g_strdup(best->title);
+	sni_title_set(summary->sni, summary->title);
+	tooltip_changed = TRUE;
+    }
+
+    if (g_strcmp0(description->str, summary->description) != 0) {
+	g_free(summary->description);
+	summary->description = g_string_free(description, FALSE);
+	tooltip_changed = TRUE;
+    }
+    else {
+	g_string_free(description, TRUE);
+    }
+
+    if (tooltip_changed) {
+	sni_tooltip_set(summary->sni, summary->title ? summary->title : "", summary->description);
+    }
+
+    if (best->icon_name != NULL && (g_strcmp0(best->icon_name, summary->icon_name) != 0 || best->icon_color != summary->icon_color)) {
+	summary->icon_name = best->icon_name;
+	summary->icon_color = best->icon_color;
+	tray_icon_set(summary->sni, summary->icon_name, summary->icon_color);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+void indicator_summary_activate(IndicatorSummary *summary) {
+    Indicator *best;
+
+    best = NULL;
+    for (Indicator *indicator = global.indicators; indicator != NULL; indicator = indicator->next) {
+	if (best == NULL || indicator_better(indicator, best)) {
+	    best = indicator;
+	}
+    }
+
+    if (best != NULL) {
+	indicator_activate(best);
+    }
+}
+
+/*
+ * Redraws every indicator after the configuration has changed, switching between
+ * per-device tray icons and the single summary icon if necessary.
+ */
+void indicators_refresh() {
+    for (Indicator *indicator = global.indicators; indicator != NULL; indicator = indicator->next) {
+	if (global.indicator_single_icon && indicator->sni != NULL) {
+	    sni_rm(indicator->sni);
+	    indicator->sni = NULL;
+	}
+	else if (!global.indicator_single_icon && indicator->sni == NULL) {
+	    indicator_sni_new(indicator);
+	}
+
+	indicator_set_device(indicator);
+
+	if (indicator->set_mode != NULL) {
+	    indicator->set_mode(indicator);
+	}
+    }
+
+    if (global.indicator_summary != NULL) {
+	if (global.indicator_single_icon) {
+	    // The icon colors may have changed
+	    global.indicator_summary->icon_name = NULL;
+	    indicator_summary_schedule();
+	}
+	else {
+	    indicator_summary_free(global.indicator_summary);
+	    global.indicator_summary = NULL;
+	}
+    }
 }
 
 void indicator_set_device(Indicator *indicator) {
@@ -157,9 +597,9 @@ void indicator_set_device(Indicator *indicator) {
     g_variant_unref(powered_var);
 
     if (!powered) {
-	sni_title_set(indicator->sni, _("Wireless hardware is disabled"));
-	sni_icon_pixmap_set(indicator->sni,
-		symbolic_icon_get_surface(ICON_ADAPTER_DISABLED, &colors.disabled_adapter));
+	indicator->rank = INDICATOR_RANK_ADAPTER_DISABLED;
+	indicator_title_set(indicator, _("Wireless hardware is disabled"));
+	indicator_icon_set(indicator, ICON_ADAPTER_DISABLED, &colors.disabled_adapter);
 	return;
     }
 
@@ -168,9 +608,9 @@ void indicator_set_device(Indicator *indicator) {
     g_variant_unref(powered_var);
 
     if (!powered) {
-	sni_title_set(indicator->sni, _("Wireless interface is disabled"));
-	sni_icon_pixmap_set(indicator->sni,
-		symbolic_icon_get_surface(ICON_DEVICE_DISABLED, &colors.disabled_device));
+	indicator->rank = INDICATOR_RANK_DEVICE_DISABLED;
+	indicator_title_set(indicator, _("Wireless interface is disabled"));
+	indicator_icon_set(indicator, ICON_DEVICE_DISABLED, &colors.disabled_device);
     }
 }
 
@@ -180,33 +620,178 @@ void indicator_set_station(Indicator *indicator) {
 
     state_var = g_dbus_proxy_get_cached_property(indicator->proxy, "State");
     state = g_variant_get_string(state_var, NULL);
+    indicator->link_state = indicator_link_state(state);
 
     if (!strcmp(state, "connected")) {
 	indicator->status = INDICATOR_STATION_CONNECTED;
-	indicator_set_station_connected_title(indicator, _("Connected to %s"));
+	indicator->rank = INDICATOR_RANK_CONNECTED;
+	indicator_set_station_connected_title(indicator);
+	indicator_poll_start(indicator, (GSourceFunc) indicator_station_poll);
+	indicator_throughput_start(indicator);
 
-	if (indicator->level <= N_SIGNAL_THRESHOLDS) {
+	if (indicator->signal.level != SIGNAL_LEVEL_UNKNOWN) {
 	    indicator_set_station_connected(indicator);
 	}
     }
     else if (!strcmp(state, "connecting")) {
 	indicator->status = INDICATOR_STATION_CONNECTING;
-	indicator_set_station_connected_title(indicator, _("Connecting to %s"));
+	indicator->rank = INDICATOR_RANK_CONNECTING;
+	indicator_set_station_connected_title(indicator);
+	indicator_poll_stop(indicator);
+	indicator_throughput_stop(indicator);
 
-	if (indicator->level <= N_SIGNAL_THRESHOLDS) {
+	if (indicator->signal.level != SIGNAL_LEVEL_UNKNOWN) {
 	    indicator_set_station_connected(indicator);
 	}
     }
     else {
 	indicator->status = INDICATOR_STATION_DISCONNECTED;
-	sni_title_set(indicator->sni, _("Not connected to any wireless network"));
-	sni_icon_pixmap_set(indicator->sni,
-		symbolic_icon_get_surface(ICON_STATION_OFFLINE, &colors.station_disconnected));
+	indicator->rank = INDICATOR_RANK_DOWN;
+	indicator_poll_stop(indicator);
+	indicator_throughput_stop(indicator);
+	indicator_title_set(indicator, _("Not connected to any wireless network"));
+	indicator_icon_set(indicator, ICON_STATION_OFFLINE, &colors.station_disconnected);
     }
 
+    indicator_tooltip_schedule(indicator);
     g_variant_unref(state_var);
 }
 
+/*
+ * The link state as shown in the tooltip. Addressing is outside of iwd's purview,
+ * so a connected link may not have an IP address yet.
+ */
+const gchar* indicator_link_state(const gchar *state) {
+    if (!strcmp(state, "connected")) {
+	return _("connected");
+    }
+    else if (!strcmp(state, "connecting")) {
+	return _("connecting");
+    }
+    else if (!strcmp(state, "roaming")) {
+	return _("roaming");
+    }
+    else if (!strcmp(state, "disconnecting")) {
+	return _("disconnecting");
+    }
+    else {
+	return _("disconnected");
+    }
+}
+
+/*
+ * While the station is connected, its tooltip shows the signal strength, band and
+ * bitrates of the link.
+ */
+gboolean indicator_station_poll(Indicator *indicator) {
+    g_dbus_connection_call(
+	g_dbus_proxy_get_connection(indicator->proxy),
+	g_dbus_proxy_get_name(indicator->proxy),
+	g_dbus_proxy_get_object_path(indicator->proxy),
+	IWD_IFACE_STATION_DIAGNOSTIC,
+	"GetDiagnostics",
+	NULL,
+	G_VARIANT_TYPE("(a{sv})"),
+	G_DBUS_CALL_FLAGS_NONE,
+	-1,
+	indicator->cancellable,
+	(GAsyncReadyCallback) indicator_station_poll_callback,
+	indicator);
+
+    return G_SOURCE_CONTINUE;
+}
+
+void indicator_station_poll_callback(GDBusConnection *connection, GAsyncResult *res, Indicator *indicator) {
+    GVariant *ret;
+    GError *err;
+
+    err = NULL;
+    ret = g_dbus_connection_call_finish(connection, res, &err);
+
+    if (ret == NULL) {
+	if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED) && !g_error_matches(err, global.iwd_error_domain, IWD_ERROR_NOT_CONNECTED)) {
+	    g_printerr("Failed to retrieve station diagnostics: %s\n", err->message);
+	}
+
+	g_error_free(err);
+	return;
+    }
+
+    // The station may have disconnected in the meantime
+    if (indicator->poll_id != 0) {
+	GVariant *diagnostics;
+
+	diagnostics = g_variant_get_child_value(ret, 0);
+	g_free(indicator->details);
+	indicator->details = indicator_station_details(diagnostics);
+	g_variant_unref(diagnostics);
+
+	indicator_tooltip_schedule(indicator);
+    }
+
+    g_variant_unref(ret);
+}
+
+/*
+ * Bitrates are reported in units of 100 kbit/s.
+ */
+gchar* indicator_station_details(GVariant *diagnostics) {
+    GVariantDict dict;
+    GString *details;
+    gint16 rssi;
+    guint32 frequency, rx_bitrate, tx_bitrate;
+    guint16 channel;
+
+    g_variant_dict_init(&dict, diagnostics);
+    details = g_string_new(NULL);
+
+    if (g_variant_dict_lookup(&dict, "RSSI", "n", &rssi)) {
+	g_string_append_printf(details, _("Signal: %d dBm"), rssi);
+    }
+
+    if (g_variant_dict_lookup(&dict, "Frequency", "u", &frequency)) {
+	const gchar *band;
+
+	if (frequency < 3000) {
+	    band = _("2.4 GHz");
+	}
+	else if (frequency < 5950) {
+	    band = _("5 GHz");
+	}
+	else {
+	    band = _("6 GHz");
+	}
+
+	if (details->len > 0) {
+	    g_string_append_c(details, '\n');
+	}
+
+	if (g_variant_dict_lookup(&dict, "Channel", "q", &channel)) {
+	    g_string_append_printf(details, _("Band: %s, channel %u"), band, channel);
+	}
+	else {
+	    g_string_append_printf(details, _("Band: %s"), band);
+	}
+    }
+
+    if (g_variant_dict_lookup(&dict, "RxBitrate", "u", &rx_bitrate) && g_variant_dict_lookup(&dict, "TxBitrate", "u", &tx_bitrate)) {
+	if (details->len > 0) {
+	    g_string_append_c(details, '\n');
+	}
+
+	g_string_append_printf(details, _("Bitrate: ↓ %.1f ↑ %.1f Mbit/s"), rx_bitrate / 10.0, tx_bitrate / 10.0);
+    }
+
+    g_variant_dict_clear(&dict);
+
+    if (details->len == 0) {
+	g_string_free(details, TRUE);
+	return NULL;
+    }
+
+    return g_string_free(details, FALSE);
+}
+
 void indicator_set_station_connected(Indicator *indicator) {
     const GdkRGBA *color;
 
@@ -221,80 +806,114 @@ void indicator_set_station_connected(Indicator *indicator) {
 	return;
     }
 
-    sni_icon_pixmap_set(indicator->sni,
-	    symbolic_icon_get_surface(station_icons[indicator->level], color));
+    indicator_icon_set(indicator, signal_level_icon(indicator->signal.level), color);
+}
+
+/*
+ * Called by the signal filter once a new level has settled.
+ */
+void indicator_signal_level_set(guint8 level, Indicator *indicator) {
+    indicator_set_station_connected(indicator);
 }
 
-void indicator_set_station_connected_title(Indicator *indicator, const gchar *title_template) {
+/*
+ * Network objects aren't cached by the indicator manager, so the SSID is fetched
+ * whenever the station's connected network changes. A lookup which is still in
+ * flight when the network changes again is canceled.
+ */
+void indicator_set_station_connected_title(Indicator *indicator) {
     GVariant *connected_network_var;
+    const gchar *network_path;
 
     connected_network_var = g_dbus_proxy_get_cached_property(indicator->proxy, "ConnectedNetwork");
 
-    if (connected_network_var) {
-	const gchar *connected_network;
-	GDBusProxy *network_proxy;
+    if (connected_network_var == NULL) {
+	g_printerr("ConnectedNetwork property was expected, but not found\n");
+	return;
+    }
 
-	connected_network = g_variant_get_string(connected_network_var, NULL);
-	network_proxy = G_DBUS_PROXY(g_dbus_object_manager_get_interface(global.manager, connected_network, IWD_IFACE_NETWORK));
+    network_path = g_variant_get_string(connected_network_var, NULL);
 
-	if (network_proxy) {
-	    sni_network_set_title(indicator->sni, network_proxy, title_template);
-	    g_object_unref(network_proxy);
-	    g_variant_unref(connected_network_var);
+    if (g_strcmp0(network_path, indicator->network_path) == 0) {
+	// If the lookup is still in flight, its callback sets the title
+	if (indicator->ssid != NULL) {
+	    indicator_station_title_set(indicator);
 	}
-	else {
-	    SNITitleDelayed *data;
 
-	    data = g_malloc(sizeof(SNITitleDelayed));
-	    data->sni = indicator->sni;
-	    data->title_template = title_template;
-	    data->connected_network_var = connected_network_var;
-	    data->handler = g_signal_connect(global.manager, "object-added", G_CALLBACK(sni_set_title_delayed), data);
-	}
+	g_variant_unref(connected_network_var);
+	return;
     }
-    else {
-	g_printerr("ConnectedNetwork property was expected, but not found\n");
+
+    if (indicator->ssid_cancellable != NULL) {
+	g_cancellable_cancel(indicator->ssid_cancellable);
+	g_object_unref(indicator->ssid_cancellable);
     }
+
+    g_free(indicator->network_path);
+    g_free(indicator->ssid);
+    indicator->network_path = g_strdup(network_path);
+    indicator->ssid = NULL;
+    indicator->ssid_cancellable = g_cancellable_new();
+
+    remote_property_get(
+	g_dbus_proxy_get_connection(indicator->proxy),
+	network_path,
+	IWD_IFACE_NETWORK,
+	"Name",
+	indicator->ssid_cancellable,
+	(GAsyncReadyCallback) indicator_set_station_connected_title_callback,
+	indicator);
+
+    g_variant_unref(connected_network_var);
 }
 
-void sni_network_set_title(StatusNotifierItem *sni, GDBusProxy *network_proxy, const gchar *title_template) {
+/*
+ * A canceled lookup means that the indicator may already have been freed.
+ */
+void indicator_set_station_connected_title_callback(GDBusConnection *connection, GAsyncResult *res, Indicator *indicator) {
     GVariant *ssid_var;
-    const gchar *ssid;
-    gchar *title;
-
-    ssid_var = g_dbus_proxy_get_cached_property(network_proxy, "Name");
-    ssid = g_variant_get_string(ssid_var, NULL);
-
-    title = g_strdup_printf(title_template, ssid);
-    sni_title_set(sni, title);
-    g_free(title);
+    GError *err;
 
-    g_variant_unref(ssid_var);
-}
+    err = NULL;
+    ssid_var = remote_property_get_finish(connection, res, &err);
 
-void sni_set_title_delayed(GDBusObjectManager *manager, GDBusObject *object, SNITitleDelayed *data) {
-    const gchar *network_path;
-    GDBusProxy *network_proxy;
+    if (ssid_var) {
+	indicator->ssid = g_variant_dup_string(ssid_var, NULL);
+	indicator_station_title_set(indicator);
+	g_variant_unref(ssid_var);
+    }
+    else {
+	if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+	    g_printerr("Failed to look up network name: %s\n", err->message);
 
-    network_path = g_variant_get_string(data->connected_network_var, NULL);
+	    // Try again on the next update
+	    g_free(indicator->network_path);
+	    indicator->network_path = NULL;
+	}
 
-    if (strcmp(g_dbus_object_get_object_path(object), network_path)) {
-	return;
+	g_error_free(err);
     }
+}
 
-    network_proxy = G_DBUS_PROXY(g_dbus_object_get_interface(object, IWD_IFACE_NETWORK));
+/*
+ * The station may have disconnected while the SSID was being looked up, in which
+ * case its title has already been set.
+ */
+void indicator_station_title_set(Indicator *indicator) {
+    gchar *title;
 
-    if (network_proxy) {
-	sni_network_set_title(data->sni, network_proxy, data->title_template);
-	g_object_unref(network_proxy);
+    if (indicator->status == INDICATOR_STATION_CONNECTED) {
+	title = g_strdup_printf(_("Connected to %s"), indicator->ssid);
+    }
+    else if (indicator->status == INDICATOR_STATION_CONNECTING) {
+	title = g_strdup_printf(_("Connecting to %s"), indicator->ssid);
     }
     else {
-	g_printerr("Failed to find interface of type " IWD_IFACE_NETWORK " on object %s\n", network_path);
+	return;
     }
 
-    g_signal_handler_disconnect(manager, data->handler);
-    g_variant_unref(data->connected_network_var);
-    g_free(data);
+    indicator_title_set(indicator, title);
+    g_free(title);
 }
 
 void indicator_set_ap(Indicator *indicator) {
@@ -303,80 +922,238 @@ void indicator_set_ap(Indicator *indicator) {
     started_var = g_dbus_proxy_get_cached_property(indicator->proxy, "Started");
 
     if (g_variant_get_boolean(started_var)) {
-	sni_title_set(indicator->sni, _("Access point is up"));
-	sni_icon_pixmap_set(indicator->sni,
-		symbolic_icon_get_surface(ICON_AP, &colors.ap_up));
+	indicator->rank = INDICATOR_RANK_UP;
+	indicator_title_set(indicator, _("Access point is up"));
+	indicator_icon_set(indicator, ICON_AP, &colors.ap_up);
+	indicator_throughput_start(indicator);
+
+	indicator_poll_start(indicator, (GSourceFunc) indicator_ap_poll);
     }
     else {
-	sni_title_set(indicator->sni, _("Access point is down"));
-	sni_icon_pixmap_set(indicator->sni,
-		symbolic_icon_get_surface(ICON_AP, &colors.ap_down));
+	indicator->rank = INDICATOR_RANK_DOWN;
+	indicator_poll_stop(indicator);
+	indicator_throughput_stop(indicator);
+	indicator_title_set(indicator, _("Access point is down"));
+	indicator_icon_set(indicator, ICON_AP, &colors.ap_down);
     }
 
     g_variant_unref(started_var);
 }
 
+/*
+ * While the access point is up, its tooltip shows the number of clients and their
+ * aggregate throughput.
+ */
+gboolean indicator_ap_poll(Indicator *indicator) {
+    g_dbus_connection_call(
+	g_dbus_proxy_get_connection(indicator->proxy),
+	g_dbus_proxy_get_name(indicator->proxy),
+	g_dbus_proxy_get_object_path(indicator->proxy),
+	IWD_IFACE_AP_DIAGNOSTIC,
+	"GetDiagnostics",
+	NULL,
+	G_VARIANT_TYPE("(aa{sv})"),
+	G_DBUS_CALL_FLAGS_NONE,
+	-1,
+	indicator->cancellable,
+	(GAsyncReadyCallback) indicator_ap_poll_callback,
+	indicator);
+
+    return G_SOURCE_CONTINUE;
+}
+
+void indicator_ap_poll_callback(GDBusConnection *connection, GAsyncResult *res, Indicator *indicator) {
+    GVariant *ret;
+    GError *err;
+
+    err = NULL;
+    ret = g_dbus_connection_call_finish(connection, res, &err);
+
+    if (ret == NULL) {
+	if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+	    g_printerr("Failed to retrieve access point diagnostics: %s\n", err->message);
+	}
+
+	g_error_free(err);
+	return;
+    }
+
+    // The access point may have stopped in the meantime
+    if (indicator->poll_id != 0) {
+	GVariant *clients;
+	guint n_clients;
+	guint64 throughput;
+
+	clients = g_variant_get_child_value(ret, 0);
+	ap_diagnostic_aggregate(clients, &n_clients, &throughput);
+	g_variant_unref(clients);
+
+	g_free(indicator->details);
+	indicator->details = ap_diagnostic_summary(n_clients, throughput);
+	indicator_tooltip_schedule(indicator);
+    }
+
+    g_variant_unref(ret);
+}
+
+/*
+ * Polls the diagnostics interface every tooltip-interval seconds, starting now. The
+ * tray doesn't know when the tooltip is shown, so this is opt-in.
+ */
+void indicator_poll_start(Indicator *indicator, GSourceFunc poll) {
+    if (global.indicator_diagnostics && indicator->poll_id == 0) {
+	indicator->poll_id = g_timeout_add_seconds(
+	    global.indicator_tooltip_interval > 0 ? global.indicator_tooltip_interval : INDICATOR_TOOLTIP_INTERVAL_DEFAULT,
+	    poll,
+	    indicator);
+	poll(indicator);
+    }
+}
+
+void indicator_poll_stop(Indicator *indicator) {
+    if (indicator->poll_id != 0) {
+	g_source_remove(indicator->poll_id);
+	indicator->poll_id = 0;
+    }
+
+    if (indicator->details != NULL) {
+	g_free(indicator->details);
+	indicator->details = NULL;
+	indicator_tooltip_schedule(indicator);
+    }
+}
+
 void indicator_set_adhoc(Indicator *indicator) {
     GVariant *started_var;
 
     started_var = g_dbus_proxy_get_cached_property(indicator->proxy, "Started");
 
     if (g_variant_get_boolean(started_var)) {
-	sni_title_set(indicator->sni, _("Ad-hoc node is up"));
-	sni_icon_pixmap_set(indicator->sni,
-		symbolic_icon_get_surface(ICON_ADHOC, &colors.adhoc_up));
+	indicator->rank = INDICATOR_RANK_UP;
+	indicator_title_set(indicator, _("Ad-hoc node is up"));
+	indicator_icon_set(indicator, ICON_ADHOC, &colors.adhoc_up);
+	indicator_throughput_start(indicator);
     }
     else {
-	sni_title_set(indicator->sni, _("Ad-hoc node is down"));
-	sni_icon_pixmap_set(indicator->sni,
-		symbolic_icon_get_surface(ICON_ADHOC, &colors.adhoc_down));
+	indicator->rank = INDICATOR_RANK_DOWN;
+	indicator_throughput_stop(indicator);
+	indicator_title_set(indicator, _("Ad-hoc node is down"));
+	indicator_icon_set(indicator, ICON_ADHOC, &colors.adhoc_down);
     }
 
     g_variant_unref(started_var);
 }
 
-void indicator_activate(GDBusObject *device_object) {
-    if (global.window != NULL) {
+/*
+ * While the link is up, the interface's throughput is shown in the tooltip, if
+ * enabled; otherwise, the tray never samples the traffic counters.
+ */
+void indicator_throughput_start(Indicator *indicator) {
+    GVariant *name_var;
+
+    if (!global.indicator_throughput || indicator->throughput_interface != NULL) {
+	return;
+    }
+
+    name_var = g_dbus_proxy_get_cached_property(indicator->device_proxy, "Name");
+    indicator->throughput_interface = g_variant_dup_string(name_var, NULL);
+    g_variant_unref(name_var);
+
+    throughput_subscribe(indicator->throughput_interface, (ThroughputCallback) indicator_throughput_set, indicator);
+}
+
+void indicator_throughput_stop(Indicator *indicator) {
+    if (indicator->throughput_interface == NULL) {
+	return;
+    }
+
+    throughput_unsubscribe(indicator->throughput_interface, (ThroughputCallback) indicator_throughput_set, indicator);
+    g_free(indicator->throughput_interface);
+    indicator->throughput_interface = NULL;
+
+    g_free(indicator->throughput);
+    indicator->throughput = NULL;
+    indicator_tooltip_schedule(indicator);
+}
+
+void indicator_throughput_set(gdouble rx_rate, gdouble tx_rate, Indicator *indicator) {
+    g_free(indicator->throughput);
+    indicator->throughput = throughput_format(rx_rate, tx_rate);
+    indicator_tooltip_schedule(indicator);
+}
+
+void indicator_activate(Indicator *indicator) {
+    if (global.state & INDICATOR_LIGHT) {
+	indicator_launch_window(indicator);
+    }
+    else if (global.window != NULL) {
 	gtk_window_destroy(GTK_WINDOW(global.window->window));
     }
     else {
-	ObjectList *list;
-
+	g_free(global.launch_device_path);
+	global.launch_device_path = g_strdup(g_dbus_proxy_get_object_path(indicator->device_proxy));
 	window_launch();
-	list = global.window->objects[OBJECT_DEVICE];
-
-	while (list != NULL) {
-	    if (list->object == device_object) {
-		Device *device;
+    }
+}
 
-		device = (Device *) list->data;
-		gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(device->button), TRUE);
-		break;
-	    }
+static void indicator_spawn_window() {
+    gchar *argv[] = {BINDIR "/" PACKAGE, NULL};
+    GError *err;
 
-	    list = list->next;
-	}
+    err = NULL;
+    if (!g_spawn_async(NULL, argv, NULL, G_SPAWN_DEFAULT, NULL, NULL, NULL, &err)) {
+	g_printerr("Failed to launch iwgtk window: %s\n", err->message);
+	g_error_free(err);
     }
 }
 
-void signal_agent_method_call_handler(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *parameters, GDBusMethodInvocation *invocation, Indicator *indicator) {
-    if (strcmp(method_name, "Changed") == 0) {
-	g_variant_get(parameters, "(oy)", NULL, &indicator->level);
-	g_dbus_method_invocation_return_value(invocation, NULL);
+/*
+ * The lightweight daemon has no user interface of its own, so it asks the full
+ * application (which the session bus starts if necessary) to open its window on
+ * the clicked device. Spawning a new process is the fallback.
+ */
+void indicator_launch_window(Indicator *indicator) {
+    GDBusConnection *session_bus;
+    GVariantBuilder parameters;
 
-	if (indicator->level <= N_SIGNAL_THRESHOLDS) {
-	    indicator_set_station_connected(indicator);
-	}
-	else {
-	    g_printerr("Invalid signal level received\n");
-	}
+    session_bus = g_application_get_dbus_connection(G_APPLICATION(global.application));
+
+    if (session_bus == NULL) {
+	indicator_spawn_window();
+	return;
     }
-    else if (strcmp(method_name, "Release") == 0) {
-	g_dbus_method_invocation_return_value(invocation, NULL);
-	g_dbus_connection_unregister_object(connection, indicator->signal_agent_id);
-	indicator->signal_agent_id = 0;
+
+    g_variant_builder_init(&parameters, G_VARIANT_TYPE("av"));
+    g_variant_builder_add(&parameters, "v", g_variant_new_string(g_dbus_proxy_get_object_path(indicator->device_proxy)));
+
+    g_dbus_connection_call(
+	session_bus,
+	APPLICATION_ID,
+	APPLICATION_PATH,
+	"org.freedesktop.Application",
+	"ActivateAction",
+	g_variant_new("(sava{sv})", "launch-device", &parameters, NULL),
+	NULL,
+	G_DBUS_CALL_FLAGS_NONE,
+	-1,
+	NULL,
+	(GAsyncReadyCallback) indicator_launch_window_callback,
+	NULL);
+}
+
+void indicator_launch_window_callback(GDBusConnection *connection, GAsyncResult *res, gpointer user_data) {
+    GVariant *ret;
+    GError *err;
+
+    err = NULL;
+    ret = g_dbus_connection_call_finish(connection, res, &err);
+
+    if (ret != NULL) {
+	g_variant_unref(ret);
     }
     else {
-	g_dbus_method_invocation_return_dbus_error(invocation, "org.freedesktop.DBus.Error.UnknownMethod", "Unknown method");
+	g_printerr("Failed to activate iwgtk window: %s\n", err->message);
+	g_error_free(err);
+	indicator_spawn_window();
     }
 }
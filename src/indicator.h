@@ -20,15 +20,32 @@
 #ifndef _IWGTK_INDICATOR_H
 #define _IWGTK_INDICATOR_H
 
+#define INDICATOR_TOOLTIP_INTERVAL_DEFAULT 5
+
 typedef enum {
     INDICATOR_STATION_CONNECTED,
     INDICATOR_STATION_CONNECTING,
     INDICATOR_STATION_DISCONNECTED,
 } IndicatorStatus;
 
+/*
+ * Orders the states of the indicators; in single-icon mode, the device in the
+ * highest ranked state is shown.
+ */
+typedef enum {
+    INDICATOR_RANK_ADAPTER_DISABLED,
+    INDICATOR_RANK_DEVICE_DISABLED,
+    INDICATOR_RANK_DOWN,
+    INDICATOR_RANK_UP,
+    INDICATOR_RANK_CONNECTING,
+    INDICATOR_RANK_CONNECTED
+} IndicatorRank;
+
 typedef struct Indicator_s Indicator;
 typedef struct StatusNotifierItem_s StatusNotifierItem;
-typedef struct SNITitleDelayed_s SNITitleDelayed;
+typedef struct IndicatorSummary_s IndicatorSummary;
+
+typedef void (*IndicatorSetter) (Indicator *indicator);
 
 struct Indicator_s {
     GDBusProxy *proxy;
@@ -40,37 +57,97 @@ struct Indicator_s {
     gulong update_device_handler;
     gulong update_adapter_handler;
     gulong update_mode_handler;
-    guint signal_agent_id;
+    IndicatorSetter set_mode;
+    GCancellable *cancellable;
 
     IndicatorStatus status;
-    guint8 level;
+    IndicatorRank rank;
+    SignalFilter signal;
+    gchar *title;
+    gchar *description;
+    const gchar *icon_name;
+    const GdkRGBA *icon_color;
+
+    // SSID of the station's connected network, looked up once per network
+    gchar *network_path;
+    gchar *ssid;
+    GCancellable *ssid_cancellable;
+
+    // Tooltip throttling
+    guint tooltip_source;
+    gboolean tooltip_pending;
+
+    // Contents of the tooltip's description
+    const gchar *link_state;
+    guint poll_id;
+    gchar *details;
+
+    // Throughput of the link, while it's up and [indicator] throughput is set
+    gchar *throughput_interface;
+    gchar *throughput;
 
     Indicator *next;
 };
 
-struct SNITitleDelayed_s {
+/*
+ * The single tray icon which summarizes every device's indicator.
+ */
+struct IndicatorSummary_s {
     StatusNotifierItem *sni;
-    const gchar *title_template;
-    GVariant *connected_network_var;
-    gulong handler;
-};
+    guint update_source;
 
-typedef void (*IndicatorSetter) (Indicator *indicator);
+    gchar *title;
+    gchar *description;
+    const gchar *icon_name;
+    const GdkRGBA *icon_color;
+};
 
 Indicator* indicator_new(GDBusProxy *device_proxy);
+void indicator_sni_new(Indicator *indicator);
 void indicator_rm(Indicator *indicator);
-void indicator_station_init_signal_agent(Indicator *indicator, GDBusProxy *station_proxy);
+void indicator_mode_rm(Indicator *indicator);
+void indicator_interface_add(GDBusProxy *proxy, ObjectType type);
+void indicator_interface_rm(GDBusProxy *proxy, ObjectType type);
+void indicator_signal_agent_changed(guint8 level_min, guint8 level_max, Indicator *indicator);
+
+void tray_icon_set(StatusNotifierItem *sni, const gchar *icon_name, const GdkRGBA *icon_color);
+void tray_icon_ready(GObject *source, GAsyncResult *res, StatusNotifierItem *sni);
+void indicator_icon_set(Indicator *indicator, const gchar *icon_name, const GdkRGBA *icon_color);
+void indicator_title_set(Indicator *indicator, const gchar *title);
+void indicator_tooltip_schedule(Indicator *indicator);
+gboolean indicator_tooltip_timeout(Indicator *indicator);
+void indicator_tooltip_update(Indicator *indicator);
+
+IndicatorSummary* indicator_summary_new();
+void indicator_summary_free(IndicatorSummary *summary);
+void indicator_summary_schedule();
+gboolean indicator_summary_update(IndicatorSummary *summary);
+void indicator_summary_activate(IndicatorSummary *summary);
 
+void indicators_refresh();
 void indicator_set_device(Indicator *indicator);
 void indicator_set_station(Indicator *indicator);
+const gchar* indicator_link_state(const gchar *state);
+gboolean indicator_station_poll(Indicator *indicator);
+void indicator_station_poll_callback(GDBusConnection *connection, GAsyncResult *res, Indicator *indicator);
+gchar* indicator_station_details(GVariant *diagnostics);
 void indicator_set_station_connected(Indicator *indicator);
-void indicator_set_station_connected_title(Indicator *indicator, const gchar *title_template);
-void sni_network_set_title(StatusNotifierItem *sni, GDBusProxy *network_proxy, const gchar *title_template);
-void sni_set_title_delayed(GDBusObjectManager *manager, GDBusObject *object, SNITitleDelayed *data);
+void indicator_signal_level_set(guint8 level, Indicator *indicator);
+void indicator_set_station_connected_title(Indicator *indicator);
+void indicator_set_station_connected_title_callback(GDBusConnection *connection, GAsyncResult *res, Indicator *indicator);
+void indicator_station_title_set(Indicator *indicator);
 void indicator_set_ap(Indicator *indicator);
+gboolean indicator_ap_poll(Indicator *indicator);
+void indicator_ap_poll_callback(GDBusConnection *connection, GAsyncResult *res, Indicator *indicator);
+void indicator_poll_start(Indicator *indicator, GSourceFunc poll);
+void indicator_poll_stop(Indicator *indicator);
 void indicator_set_adhoc(Indicator *indicator);
+void indicator_throughput_start(Indicator *indicator);
+void indicator_throughput_stop(Indicator *indicator);
+void indicator_throughput_set(gdouble rx_rate, gdouble tx_rate, Indicator *indicator);
 
-void indicator_activate(GDBusObject *device_object);
-void signal_agent_method_call_handler(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *parameters, GDBusMethodInvocation *invocation, Indicator *indicator);
+void indicator_activate(Indicator *indicator);
+void indicator_launch_window(Indicator *indicator);
+void indicator_launch_window_callback(GDBusConnection *connection, GAsyncResult *res, gpointer user_data);
 
 #endif
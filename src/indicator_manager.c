@@ -0,0 +1,443 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+/*
+ * The interfaces that get cached proxies, in the order in which they are handed to
+ * the indicators when they appear at the same time. Removal is in reverse order.
+ */
+const ObjectType indicator_object_types[] = {
+    OBJECT_ADAPTER,
+    OBJECT_DEVICE,
+    OBJECT_STATION,
+    OBJECT_ACCESS_POINT,
+    OBJECT_ADHOC
+};
+
+IndicatorManager* indicator_manager_new(GDBusConnection *connection, const gchar *name_owner) {
+    IndicatorManager *manager;
+
+    manager = g_malloc(sizeof(IndicatorManager));
+    manager->connection = g_object_ref(connection);
+    manager->name_owner = g_strdup(name_owner);
+    manager->cancellable = g_cancellable_new();
+    manager->objects = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_hash_table_unref);
+    manager->indicators = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    manager->interfaces_added_id = g_dbus_connection_signal_subscribe(
+	connection,
+	name_owner,
+	"org.freedesktop.DBus.ObjectManager",
+	"InterfacesAdded",
+	IWD_PATH_OBJECT_MANAGER,
+	NULL,
+	G_DBUS_SIGNAL_FLAGS_NONE,
+	(GDBusSignalCallback) indicator_manager_interfaces_added,
+	manager,
+	NULL);
+
+    manager->interfaces_removed_id = g_dbus_connection_signal_subscribe(
+	connection,
+	name_owner,
+	"org.freedesktop.DBus.ObjectManager",
+	"InterfacesRemoved",
+	IWD_PATH_OBJECT_MANAGER,
+	NULL,
+	G_DBUS_SIGNAL_FLAGS_NONE,
+	(GDBusSignalCallback) indicator_manager_interfaces_removed,
+	manager,
+	NULL);
+
+    /*
+     * Match on arg0 (the interface name) so that the bus doesn't wake us up for
+     * property changes on interfaces we don't track.
+     */
+    for (int i = 0; i < N_INDICATOR_OBJECT_TYPES; i ++) {
+	manager->properties_changed_id[i] = g_dbus_connection_signal_subscribe(
+	    connection,
+	    name_owner,
+	    "org.freedesktop.DBus.Properties",
+	    "PropertiesChanged",
+	    NULL,
+	    object_methods[indicator_object_types[i]].interface,
+	    G_DBUS_SIGNAL_FLAGS_NONE,
+	    (GDBusSignalCallback) indicator_manager_properties_changed,
+	    manager,
+	    NULL);
+    }
+
+    g_dbus_connection_call(
+	connection,
+	name_owner,
+	IWD_PATH_OBJECT_MANAGER,
+	"org.freedesktop.DBus.ObjectManager",
+	"GetManagedObjects",
+	NULL,
+	G_VARIANT_TYPE("(a{oa{sa{sv}}})"),
+	G_DBUS_CALL_FLAGS_NONE,
+	-1,
+	manager->cancellable,
+	(GAsyncReadyCallback) indicator_manager_objects_callback,
+	manager);
+
+    return manager;
+}
+
+/*
+ * Removes all indicators, since they hold references to this manager's proxies.
+ */
+void indicator_manager_free(IndicatorManager *manager) {
+    g_cancellable_cancel(manager->cancellable);
+    g_object_unref(manager->cancellable);
+
+    g_dbus_connection_signal_unsubscribe(manager->connection, manager->interfaces_added_id);
+    g_dbus_connection_signal_unsubscribe(manager->connection, manager->interfaces_removed_id);
+
+    for (int i = 0; i < N_INDICATOR_OBJECT_TYPES; i ++) {
+	g_dbus_connection_signal_unsubscribe(manager->connection, manager->properties_changed_id[i]);
+    }
+
+    g_hash_table_remove_all(manager->indicators);
+
+    while (global.indicators != NULL) {
+	Indicator *rm;
+
+	rm = global.indicators;
+	global.indicators = rm->next;
+	indicator_rm(rm);
+    }
+
+    g_hash_table_unref(manager->indicators);
+    g_hash_table_unref(manager->objects);
+    g_object_unref(manager->connection);
+    g_free(manager->name_owner);
+    g_free(manager);
+}
+
+/*
+ * Returns a new reference, or NULL if the interface isn't one that this manager
+ * caches.
+ */
+GDBusProxy* indicator_manager_get_interface(IndicatorManager *manager, const gchar *object_path, const gchar *interface_name) {
+    GHashTable *interfaces;
+    GDBusProxy *proxy;
+
+    interfaces = g_hash_table_lookup(manager->objects, object_path);
+
+    if (interfaces == NULL) {
+	return NULL;
+    }
+
+    proxy = g_hash_table_lookup(interfaces, interface_name);
+    return proxy ? g_object_ref(proxy) : NULL;
+}
+
+guint indicator_manager_count_proxies(IndicatorManager *manager) {
+    GHashTableIter iter;
+    GHashTable *interfaces;
+    guint n;
+
+    n = 0;
+    g_hash_table_iter_init(&iter, manager->objects);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &interfaces)) {
+	n += g_hash_table_size(interfaces);
+    }
+
+    return n;
+}
+
+/*
+ * Returns the index into indicator_object_types[], or -1 if the interface isn't
+ * tracked.
+ */
+int indicator_manager_object_type(const gchar *interface_name) {
+    for (int i = 0; i < N_INDICATOR_OBJECT_TYPES; i ++) {
+	if (strcmp(interface_name, object_methods[indicator_object_types[i]].interface) == 0) {
+	    return i;
+	}
+    }
+
+    return -1;
+}
+
+/*
+ * Creates proxies for the tracked interfaces in an a{sa{sv}} dictionary. Returns a
+ * bitmask of the newly added interfaces, indexed by indicator_manager_object_type().
+ *
+ * An InterfacesAdded signal can arrive before the GetManagedObjects reply, so an
+ * interface may already have a proxy. It's kept, since its indicator is bound to it
+ * and PropertiesChanged keeps it up to date.
+ */
+guint indicator_manager_interfaces_add(IndicatorManager *manager, const gchar *object_path, GVariant *interfaces) {
+    GHashTable *object;
+    GVariantIter iter;
+    const gchar *interface_name;
+    GVariant *properties;
+    guint type_mask;
+
+    object = NULL;
+    type_mask = 0;
+
+    g_variant_iter_init(&iter, interfaces);
+    while (g_variant_iter_next(&iter, "{&s@a{sv}}", &interface_name, &properties)) {
+	GDBusProxy *proxy;
+	GError *err;
+	int type;
+
+	type = indicator_manager_object_type(interface_name);
+
+	if (type == -1) {
+	    g_variant_unref(properties);
+	    continue;
+	}
+
+	/*
+	 * Networks and known networks never get this far, so they don't cost a
+	 * lookup.
+	 */
+	if (object == NULL) {
+	    object = g_hash_table_lookup(manager->objects, object_path);
+	}
+
+	if (object != NULL && g_hash_table_contains(object, object_methods[indicator_object_types[type]].interface)) {
+	    g_variant_unref(properties);
+	    continue;
+	}
+
+	/*
+	 * With a unique bus name and these flags, the proxy is set up without any
+	 * D-Bus round trips.
+	 */
+	err = NULL;
+	proxy = g_dbus_proxy_new_sync(
+	    manager->connection,
+	    G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES | G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS | G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START,
+	    NULL,
+	    manager->name_owner,
+	    object_path,
+	    interface_name,
+	    NULL,
+	    &err);
+
+	if (proxy == NULL) {
+	    g_printerr("Failed to create proxy for %s on %s: %s\n", interface_name, object_path, err->message);
+	    g_error_free(err);
+	    g_variant_unref(properties);
+	    continue;
+	}
+
+	{
+	    GVariantIter property_iter;
+	    const gchar *property_name;
+	    GVariant *value;
+
+	    g_variant_iter_init(&property_iter, properties);
+	    while (g_variant_iter_next(&property_iter, "{&sv}", &property_name, &value)) {
+		g_dbus_proxy_set_cached_property(proxy, property_name, value);
+		g_variant_unref(value);
+	    }
+	}
+
+	if (object == NULL) {
+	    object = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_object_unref);
+	    g_hash_table_insert(manager->objects, g_strdup(object_path), object);
+	}
+
+	g_hash_table_insert(object, (gpointer) object_methods[indicator_object_types[type]].interface, proxy);
+	type_mask |= 1 << type;
+
+	g_variant_unref(properties);
+    }
+
+    return type_mask;
+}
+
+void indicator_manager_dispatch(IndicatorManager *manager, const gchar *object_path, guint type_mask) {
+    for (int i = 0; i < N_INDICATOR_OBJECT_TYPES; i ++) {
+	if (type_mask & (1 << i)) {
+	    GDBusProxy *proxy;
+
+	    proxy = indicator_manager_get_interface(manager, object_path, object_methods[indicator_object_types[i]].interface);
+	    indicator_interface_add(proxy, indicator_object_types[i]);
+	    g_object_unref(proxy);
+	}
+    }
+}
+
+void indicator_manager_objects_callback(GDBusConnection *connection, GAsyncResult *res, IndicatorManager *manager) {
+    GVariant *ret, *objects;
+    GError *err;
+    gsize n;
+    guint *type_masks;
+
+    err = NULL;
+    ret = g_dbus_connection_call_finish(connection, res, &err);
+
+    if (ret == NULL) {
+	if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+	    g_printerr("Failed to retrieve iwd objects: %s\n", err->message);
+	}
+
+	g_error_free(err);
+	return;
+    }
+
+    startup_mark(STARTUP_IWD_DATA);
+
+    watchdog_mark("GetManagedObjects");
+
+    /*
+     * Create every proxy before creating any indicators, since an indicator
+     * needs its device's adapter.
+     */
+    objects = g_variant_get_child_value(ret, 0);
+    n = g_variant_n_children(objects);
+    type_masks = g_new(guint, n);
+
+    for (gsize i = 0; i < n; i ++) {
+	const gchar *object_path;
+	GVariant *interfaces;
+
+	g_variant_get_child(objects, i, "{&o@a{sa{sv}}}", &object_path, &interfaces);
+	type_masks[i] = indicator_manager_interfaces_add(manager, object_path, interfaces);
+	g_variant_unref(interfaces);
+    }
+
+    for (gsize i = 0; i < n; i ++) {
+	const gchar *object_path;
+
+	g_variant_get_child(objects, i, "{&o@a{sa{sv}}}", &object_path, NULL);
+	indicator_manager_dispatch(manager, object_path, type_masks[i]);
+    }
+
+    g_free(type_masks);
+    g_variant_unref(objects);
+    g_variant_unref(ret);
+}
+
+void indicator_manager_interfaces_added(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *signal_name, GVariant *parameters, IndicatorManager *manager) {
+    const gchar *path;
+    GVariant *interfaces;
+    guint type_mask;
+
+    g_variant_get(parameters, "(&o@a{sa{sv}})", &path, &interfaces);
+    type_mask = indicator_manager_interfaces_add(manager, path, interfaces);
+    g_variant_unref(interfaces);
+
+    if (type_mask != 0) {
+	watchdog_mark("InterfacesAdded %s", path);
+	indicator_manager_dispatch(manager, path, type_mask);
+    }
+}
+
+void indicator_manager_interfaces_removed(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *signal_name, GVariant *parameters, IndicatorManager *manager) {
+    const gchar *path;
+    GVariant *interface_names;
+    GHashTable *object;
+    guint type_mask;
+
+    g_variant_get(parameters, "(&o@as)", &path, &interface_names);
+    type_mask = 0;
+
+    {
+	GVariantIter iter;
+	const gchar *name;
+	int type;
+
+	g_variant_iter_init(&iter, interface_names);
+	while (g_variant_iter_next(&iter, "&s", &name)) {
+	    type = indicator_manager_object_type(name);
+
+	    if (type != -1) {
+		type_mask |= 1 << type;
+	    }
+	}
+    }
+
+    g_variant_unref(interface_names);
+
+    // Removals of networks and known networks end here, without a lookup
+    if (type_mask == 0) {
+	return;
+    }
+
+    object = g_hash_table_lookup(manager->objects, path);
+
+    if (object == NULL) {
+	return;
+    }
+
+    watchdog_mark("InterfacesRemoved %s", path);
+
+    for (int i = N_INDICATOR_OBJECT_TYPES - 1; i >= 0; i --) {
+	if (type_mask & (1 << i)) {
+	    const gchar *name;
+	    GDBusProxy *proxy;
+
+	    name = object_methods[indicator_object_types[i]].interface;
+	    proxy = g_hash_table_lookup(object, name);
+
+	    if (proxy != NULL) {
+		indicator_interface_rm(proxy, indicator_object_types[i]);
+		g_hash_table_remove(object, name);
+	    }
+	}
+    }
+
+    if (g_hash_table_size(object) == 0) {
+	g_hash_table_remove(manager->objects, path);
+    }
+}
+
+/*
+ * Does for our proxies what GDBusObjectManagerClient does for its own: update the
+ * property cache, then emit g-properties-changed.
+ */
+void indicator_manager_properties_changed(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *signal_name, GVariant *parameters, IndicatorManager *manager) {
+    const gchar *name;
+    GVariant *changed;
+    const gchar **invalidated;
+    GDBusProxy *proxy;
+
+    g_variant_get(parameters, "(&s@a{sv}^a&s)", &name, &changed, &invalidated);
+    proxy = indicator_manager_get_interface(manager, object_path, name);
+
+    if (proxy != NULL) {
+	GVariantIter iter;
+	const gchar *property_name;
+	GVariant *value;
+
+	g_variant_iter_init(&iter, changed);
+	while (g_variant_iter_next(&iter, "{&sv}", &property_name, &value)) {
+	    g_dbus_proxy_set_cached_property(proxy, property_name, value);
+	    g_variant_unref(value);
+	}
+
+	for (int i = 0; invalidated[i] != NULL; i ++) {
+	    g_dbus_proxy_set_cached_property(proxy, invalidated[i], NULL);
+	}
+
+	g_signal_emit_by_name(proxy, "g-properties-changed", changed, invalidated);
+	g_object_unref(proxy);
+    }
+
+    g_variant_unref(changed);
+    g_free(invalidated);
+}
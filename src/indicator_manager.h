@@ -0,0 +1,64 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_INDICATOR_MANAGER_H
+#define _IWGTK_INDICATOR_MANAGER_H
+
+#define N_INDICATOR_OBJECT_TYPES 5
+
+typedef struct IndicatorManager_s IndicatorManager;
+
+/*
+ * A minimal replacement for GDBusObjectManagerClient, used by the indicator daemon.
+ * Proxies are only created for the interfaces which the indicators read; everything
+ * else that iwd exports (networks in particular) is dropped as soon as it arrives.
+ */
+struct IndicatorManager_s {
+    GDBusConnection *connection;
+    gchar *name_owner;
+    GCancellable *cancellable;
+
+    guint interfaces_added_id;
+    guint interfaces_removed_id;
+    guint properties_changed_id[N_INDICATOR_OBJECT_TYPES];
+
+    // Object path -> (interface name -> GDBusProxy)
+    GHashTable *objects;
+
+    // Device object path -> Indicator, indexing global.indicators
+    GHashTable *indicators;
+};
+
+extern const ObjectType indicator_object_types[];
+
+IndicatorManager* indicator_manager_new(GDBusConnection *connection, const gchar *name_owner);
+void indicator_manager_free(IndicatorManager *manager);
+GDBusProxy* indicator_manager_get_interface(IndicatorManager *manager, const gchar *object_path, const gchar *interface_name);
+guint indicator_manager_count_proxies(IndicatorManager *manager);
+
+int indicator_manager_object_type(const gchar *interface_name);
+guint indicator_manager_interfaces_add(IndicatorManager *manager, const gchar *object_path, GVariant *interfaces);
+void indicator_manager_dispatch(IndicatorManager *manager, const gchar *object_path, guint type_mask);
+
+void indicator_manager_objects_callback(GDBusConnection *connection, GAsyncResult *res, IndicatorManager *manager);
+void indicator_manager_interfaces_added(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *signal_name, GVariant *parameters, IndicatorManager *manager);
+void indicator_manager_interfaces_removed(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *signal_name, GVariant *parameters, IndicatorManager *manager);
+void indicator_manager_properties_changed(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *signal_name, GVariant *parameters, IndicatorManager *manager);
+
+#endif
@@ -25,6 +25,8 @@
 #include <glib/gi18n.h>
 
 #define APPLICATION_ID "org.twosheds.iwgtk"
+#define APPLICATION_ID_LIGHT APPLICATION_ID ".Indicator"
+#define APPLICATION_PATH "/org/twosheds/iwgtk"
 
 #define IWD_BUS_NAME "net.connman.iwd"
 
@@ -99,11 +101,25 @@ struct CallbackMessages_s {
     gboolean free;
 };
 
+#include "signal_level.h"
+#include "signal_history.h"
+#include "signal_agent.h"
 #include "sni.h"
-#include "indicator.h"
 #include "window.h"
+#include "indicator.h"
+#include "indicator_manager.h"
+#include "connect_latency.h"
+#include "failover.h"
+#include "survey.h"
+#include "recorder.h"
+#include "throughput.h"
 #include "main.h"
 #include "utilities.h"
+#include "pending.h"
+#include "stats.h"
+#include "debug.h"
+#include "watchdog.h"
+#include "worker.h"
 #include "icon.h"
 
 #include "dialog.h"
@@ -115,6 +131,7 @@ struct CallbackMessages_s {
 #include "dpp.h"
 #include "wps.h"
 #include "diagnostic.h"
+#include "ap_diagnostic.h"
 #include "known_network.h"
 #include "agent.h"
 #include "network.h"
@@ -21,16 +21,97 @@
 
 static int n_known_networks = 0;
 
-void known_network_forget(GDBusProxy *proxy) {
-    g_dbus_proxy_call(
-	proxy,
+void known_network_forget(KnownNetwork *kn) {
+    pending_call(
+	kn->proxy,
 	"Forget",
 	NULL,
-	G_DBUS_CALL_FLAGS_NONE,
-	-1,
-	NULL,
+	PENDING_TIMEOUT_DEFAULT,
 	(GAsyncReadyCallback) method_call_log,
-	"Failed to forget known network: %s\n");
+	"Failed to forget known network: %s\n",
+	(PendingRefresh) known_network_set,
+	kn);
+}
+
+static gchar* known_network_key(KnownNetwork *kn) {
+    GVariant *name_var, *type_var;
+    gchar *key;
+
+    name_var = g_dbus_proxy_get_cached_property(kn->proxy, "Name");
+    type_var = g_dbus_proxy_get_cached_property(kn->proxy, "Type");
+    key = connect_latency_key(g_variant_get_string(name_var, NULL), g_variant_get_string(type_var, NULL));
+    g_variant_unref(name_var);
+    g_variant_unref(type_var);
+
+    return key;
+}
+
+void known_network_latency_set(KnownNetwork *kn) {
+    gchar *key;
+    guint median, p95, attempts, failures;
+
+    key = known_network_key(kn);
+
+    if (!connect_latency_summary(key, &median, &p95, &attempts, &failures)) {
+	gtk_label_set_text(GTK_LABEL(kn->latency_label), NULL);
+	gtk_widget_set_tooltip_text(kn->latency_label, NULL);
+    }
+    else {
+	gchar *text, *tooltip;
+
+	if (failures == attempts) {
+	    text = g_strdup(_("Failed"));
+	}
+	else {
+	    gchar *median_str, *p95_str;
+
+	    median_str = connect_latency_format(median);
+	    p95_str = connect_latency_format(p95);
+
+	    /*
+	     * Translators: The median and 95th percentile of the time taken to
+	     * connect to a network
+	     */
+	    text = g_strdup_printf(_("Median %s\n95%% %s"), median_str, p95_str);
+
+	    g_free(median_str);
+	    g_free(p95_str);
+	}
+
+	tooltip = g_strdup_printf(
+	    ngettext("Time to connect, excluding time spent entering credentials: %u attempt, %u failed",
+		     "Time to connect, excluding time spent entering credentials: %u attempts, %u failed",
+		     attempts),
+	    attempts, failures);
+
+	gtk_label_set_text(GTK_LABEL(kn->latency_label), text);
+	gtk_widget_set_tooltip_text(kn->latency_label, tooltip);
+
+	g_free(text);
+	g_free(tooltip);
+    }
+
+    g_free(key);
+}
+
+/*
+ * Refreshes the latencies of the known network with the given key, after a
+ * connection attempt.
+ */
+void known_networks_latency_update(Window *window, const gchar *key) {
+    for (ObjectList *list = window->objects[OBJECT_KNOWN_NETWORK]; list != NULL; list = list->next) {
+	KnownNetwork *kn;
+	gchar *kn_key;
+
+	kn = (KnownNetwork *) list->data;
+	kn_key = known_network_key(kn);
+
+	if (!strcmp(kn_key, key)) {
+	    known_network_latency_set(kn);
+	}
+
+	g_free(kn_key);
+    }
 }
 
 void known_network_set(KnownNetwork *kn) {
@@ -44,6 +125,15 @@ void known_network_set(KnownNetwork *kn) {
 	g_variant_unref(name_var);
     }
 
+    {
+	gboolean forgetting;
+
+	// The row is greyed out until iwd removes the network
+	forgetting = pending_find(kn->proxy, "Forget");
+	gtk_widget_set_sensitive(kn->name_label, !forgetting);
+	gtk_widget_set_sensitive(kn->forget_button, !forgetting);
+    }
+
     {
 	GVariant *type_var;
 	const gchar *type_raw;
@@ -95,11 +185,13 @@ void known_network_set(KnownNetwork *kn) {
 	    gtk_label_set_text(GTK_LABEL(kn->last_connection_label), _("Never"));
 	}
     }
+
+    known_network_latency_set(kn);
 }
 
 KnownNetwork* known_network_add(Window *window, GDBusObject *object, GDBusProxy *proxy) {
     KnownNetwork *kn;
-    GtkWidget *name_box, *autoconnect_switch, *forget_button;
+    GtkWidget *name_box, *autoconnect_switch;
 
     kn = g_malloc(sizeof(KnownNetwork));
     kn->proxy = proxy;
@@ -122,14 +214,18 @@ KnownNetwork* known_network_add(Window *window, GDBusObject *object, GDBusProxy
     autoconnect_switch = switch_new(proxy, "AutoConnect");
     gtk_widget_set_tooltip_text(autoconnect_switch, _("Automatically connect to this network"));
 
-    forget_button = gtk_button_new_with_label(_("Forget"));
-    g_signal_connect_swapped(forget_button, "clicked", G_CALLBACK(known_network_forget), proxy);
-    gtk_widget_set_tooltip_text(forget_button, _("Forget this network"));
+    kn->forget_button = gtk_button_new_with_label(_("Forget"));
+    g_object_ref_sink(kn->forget_button);
+    g_signal_connect_swapped(kn->forget_button, "clicked", G_CALLBACK(known_network_forget), kn);
+    gtk_widget_set_tooltip_text(kn->forget_button, _("Forget this network"));
 
     kn->last_connection_label = gtk_label_new(NULL);
     g_object_ref_sink(kn->last_connection_label);
     gtk_widget_set_tooltip_text(kn->last_connection_label, _("Most recent connection to this network"));
 
+    kn->latency_label = gtk_label_new(NULL);
+    g_object_ref_sink(kn->latency_label);
+
     gtk_widget_set_hexpand(name_box, TRUE);
 
     gtk_widget_set_halign(name_box,                  GTK_ALIGN_START);
@@ -138,14 +234,16 @@ KnownNetwork* known_network_add(Window *window, GDBusObject *object, GDBusProxy
 
     gtk_widget_set_halign(kn->security_label,        GTK_ALIGN_START);
     gtk_widget_set_halign(autoconnect_switch,        GTK_ALIGN_START);
-    gtk_widget_set_halign(forget_button,             GTK_ALIGN_START);
+    gtk_widget_set_halign(kn->forget_button,         GTK_ALIGN_START);
     gtk_widget_set_halign(kn->last_connection_label, GTK_ALIGN_START);
+    gtk_widget_set_halign(kn->latency_label,         GTK_ALIGN_START);
 
     gtk_grid_attach(GTK_GRID(window->known_network_table), name_box,                  0, n_known_networks, 1, 1);
     gtk_grid_attach(GTK_GRID(window->known_network_table), kn->security_label,        1, n_known_networks, 1, 1);
     gtk_grid_attach(GTK_GRID(window->known_network_table), autoconnect_switch,        2, n_known_networks, 1, 1);
-    gtk_grid_attach(GTK_GRID(window->known_network_table), forget_button,             3, n_known_networks, 1, 1);
+    gtk_grid_attach(GTK_GRID(window->known_network_table), kn->forget_button,         3, n_known_networks, 1, 1);
     gtk_grid_attach(GTK_GRID(window->known_network_table), kn->last_connection_label, 4, n_known_networks, 1, 1);
+    gtk_grid_attach(GTK_GRID(window->known_network_table), kn->latency_label,         5, n_known_networks, 1, 1);
 
     kn->handler_update = g_signal_connect_swapped(proxy, "g-properties-changed", G_CALLBACK(known_network_set), kn);
     known_network_set(kn);
@@ -156,6 +254,7 @@ KnownNetwork* known_network_add(Window *window, GDBusObject *object, GDBusProxy
 }
 
 void known_network_remove(Window *window, KnownNetwork *kn) {
+    pending_refresh_cancel(kn);
     g_signal_handler_disconnect(kn->proxy, kn->handler_update);
 
     {
@@ -169,6 +268,8 @@ void known_network_remove(Window *window, KnownNetwork *kn) {
     g_object_unref(kn->hidden_label);
     g_object_unref(kn->security_label);
     g_object_unref(kn->last_connection_label);
+    g_object_unref(kn->latency_label);
+    g_object_unref(kn->forget_button);
     g_free(kn);
 
     n_known_networks --;
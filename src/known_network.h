@@ -31,9 +31,13 @@ struct KnownNetwork_s {
     GtkWidget *hidden_label;
     GtkWidget *security_label;
     GtkWidget *last_connection_label;
+    GtkWidget *latency_label;
+    GtkWidget *forget_button;
 };
 
-void known_network_forget(GDBusProxy *proxy);
+void known_network_forget(KnownNetwork *kn);
+void known_network_latency_set(KnownNetwork *kn);
+void known_networks_latency_update(Window *window, const gchar *key);
 KnownNetwork* known_network_add(Window *window, GDBusObject *object, GDBusProxy *proxy);
 void known_network_remove(Window *window, KnownNetwork *known_network);
 
@@ -18,6 +18,8 @@
  */
 
 #include <locale.h>
+#include <signal.h>
+#include <glib-unix.h>
 #include "iwgtk.h"
 
 GlobalData global;
@@ -58,6 +60,15 @@ static const GOptionEntry command_options[] = {
 	N_("Start indicator (tray) icon daemon"),
 	NULL
     },
+    {
+	"light-indicators",
+	'l',
+	G_OPTION_FLAG_NONE,
+	G_OPTION_ARG_NONE,
+	NULL,
+	N_("Start a lightweight indicator daemon, without the GTK user interface"),
+	NULL
+    },
     {
 	"notifications",
 	'n',
@@ -76,6 +87,60 @@ static const GOptionEntry command_options[] = {
 	N_("Disable desktop notifications"),
 	NULL
     },
+    {
+	"stats",
+	's',
+	G_OPTION_FLAG_NONE,
+	G_OPTION_ARG_NONE,
+	NULL,
+	N_("Print statistics of the running instance"),
+	NULL
+    },
+    {
+	"survey",
+	'S',
+	G_OPTION_FLAG_NONE,
+	G_OPTION_ARG_FILENAME,
+	NULL,
+	N_("Record a site survey to FILE while the window is open"),
+	N_("FILE")
+    },
+    {
+	"survey-export",
+	0,
+	G_OPTION_FLAG_NONE,
+	G_OPTION_ARG_FILENAME,
+	NULL,
+	N_("Print the contents of a site survey file"),
+	N_("FILE")
+    },
+    {
+	"survey-format",
+	0,
+	G_OPTION_FLAG_NONE,
+	G_OPTION_ARG_STRING,
+	NULL,
+	N_("Survey export format: csv (default) or json"),
+	N_("FORMAT")
+    },
+    {
+	"diagnostics-export",
+	0,
+	G_OPTION_FLAG_NONE,
+	G_OPTION_ARG_FILENAME,
+	NULL,
+	N_("Print a diagnostics recording, including its rotated files"),
+	N_("FILE")
+    },
+    {
+	"diagnostics-format",
+	0,
+	G_OPTION_FLAG_NONE,
+	G_OPTION_ARG_STRING,
+	NULL,
+	N_("Diagnostics export format: csv (default) or json"),
+	N_("FORMAT")
+    },
     {
 	"version",
 	'V',
@@ -88,23 +153,32 @@ static const GOptionEntry command_options[] = {
     {NULL}
 };
 
-void object_manager_callback(GDBusObjectManagerClient *manager, GAsyncResult *res) {
-    gboolean launch_window;
+/*
+ * The full GDBusObjectManagerClient is only needed by the window.
+ */
+void object_manager_new(GDBusConnection *connection) {
+    g_dbus_object_manager_client_new(
+	connection,
+	G_DBUS_OBJECT_MANAGER_CLIENT_FLAGS_NONE,
+	IWD_BUS_NAME,
+	IWD_PATH_OBJECT_MANAGER,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	(GAsyncReadyCallback) object_manager_callback,
+	NULL
+    );
+}
 
-    if (global.state & WINDOW_LAUNCH_PENDING) {
-	global.state &= ~WINDOW_LAUNCH_PENDING;
-	g_application_release(G_APPLICATION(global.application));
-	launch_window = TRUE;
-    }
-    else {
-	launch_window = FALSE;
-    }
+void object_manager_callback(GDBusObjectManagerClient *manager, GAsyncResult *res) {
+    GDBusObjectManager *object_manager;
 
     {
 	GError *err;
 
 	err = NULL;
-	global.manager = g_dbus_object_manager_client_new_finish(res, &err);
+	object_manager = g_dbus_object_manager_client_new_finish(res, &err);
 
 	if (err) {
 	    if (err->domain == G_DBUS_ERROR && err->code == G_DBUS_ERROR_ACCESS_DENIED) {
@@ -115,46 +189,97 @@ void object_manager_callback(GDBusObjectManagerClient *manager, GAsyncResult *re
 	    }
 
 	    g_error_free(err);
+
+	    if (global.state & WINDOW_LAUNCH_PENDING) {
+		global.state &= ~WINDOW_LAUNCH_PENDING;
+		g_application_release(G_APPLICATION(global.application));
+	    }
+
 	    return;
 	}
     }
 
-    if (launch_window) {
-	window_launch();
+    if (~global.state & WINDOW_LAUNCH_PENDING) {
+	// The launch has been called off, e.g. because iwd has gone down in the meantime
+	g_object_unref(object_manager);
+	return;
     }
 
-    if (global.state & INDICATOR_DAEMON) {
-	add_all_dbus_objects(NULL);
-    }
+    global.manager = object_manager;
+    startup_mark(STARTUP_IWD_DATA);
 
     g_signal_connect(global.manager, "interface-added",   G_CALLBACK(interface_add), NULL);
     g_signal_connect(global.manager, "interface-removed", G_CALLBACK(interface_rm),  NULL);
     g_signal_connect(global.manager, "object-added",      G_CALLBACK(object_add),    NULL);
     g_signal_connect(global.manager, "object-removed",    G_CALLBACK(object_rm),     NULL);
 
-    {
-	GDBusProxy *agent_manager;
+    window_launch_pending();
+}
 
-	agent_manager = G_DBUS_PROXY(g_dbus_object_manager_get_interface(global.manager, IWD_PATH_AGENT_MANAGER, IWD_IFACE_AGENT_MANAGER));
-	agent_register(agent_manager);
+/*
+ * A pending window is launched once both the object manager and the
+ * configuration are available, whichever of them comes last.
+ */
+void window_launch_pending() {
+    if ((global.state & WINDOW_LAUNCH_PENDING) && global.manager != NULL && (~global.state & CONFIG_PENDING)) {
+	global.state &= ~WINDOW_LAUNCH_PENDING;
+	g_application_release(G_APPLICATION(global.application));
+	window_launch();
     }
 }
 
-void iwd_up(GDBusConnection *connection) {
+/*
+ * The indicators get their own lightweight object manager, which only caches the
+ * handful of interfaces they need.
+ */
+void indicators_start() {
+    if (global.indicator_manager == NULL && global.system_bus != NULL) {
+	global.indicator_manager = indicator_manager_new(global.system_bus, global.iwd_name_owner);
+    }
+}
+
+void iwd_up(GDBusConnection *connection, const gchar *name, const gchar *name_owner) {
+    startup_mark(STARTUP_IWD_UP);
     global.state &= ~IWD_DOWN;
+    global.system_bus = g_object_ref(connection);
+    global.iwd_name_owner = g_strdup(name_owner);
+    stats_connection_watch(connection, "system");
+
+    /*
+     * The lightweight daemon can't show credential prompts. The window is
+     * a separate process in that case, and registers an agent of its own.
+     */
+    if (~global.state & INDICATOR_LIGHT) {
+	GDBusProxy *agent_manager;
+	GError *err;
 
-    g_dbus_object_manager_client_new(
-	connection,
-	G_DBUS_OBJECT_MANAGER_CLIENT_FLAGS_NONE,
-	IWD_BUS_NAME,
-	IWD_PATH_OBJECT_MANAGER,
-	NULL,
-	NULL,
-	NULL,
-	NULL,
-	(GAsyncReadyCallback) object_manager_callback,
-	NULL
-    );
+	err = NULL;
+	agent_manager = g_dbus_proxy_new_sync(
+	    connection,
+	    G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES | G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
+	    NULL,
+	    name_owner,
+	    IWD_PATH_AGENT_MANAGER,
+	    IWD_IFACE_AGENT_MANAGER,
+	    NULL,
+	    &err);
+
+	if (agent_manager) {
+	    agent_register(agent_manager);
+	}
+	else {
+	    g_printerr("Agent registration has failed: %s\n", err->message);
+	    g_error_free(err);
+	}
+    }
+
+    if (global.state & INDICATOR_DAEMON) {
+	indicators_start();
+    }
+
+    if (global.state & WINDOW_LAUNCH_PENDING) {
+	object_manager_new(connection);
+    }
 }
 
 void iwd_down(GDBusConnection *connection) {
@@ -171,11 +296,26 @@ void iwd_down(GDBusConnection *connection) {
 	global.manager = NULL;
     }
 
+    if (global.indicator_manager != NULL) {
+	indicator_manager_free(global.indicator_manager);
+	global.indicator_manager = NULL;
+    }
+
+    if (global.system_bus != NULL) {
+	g_object_unref(global.system_bus);
+	global.system_bus = NULL;
+	g_free(global.iwd_name_owner);
+	global.iwd_name_owner = NULL;
+    }
+
     if (global.state & WINDOW_LAUNCH_PENDING) {
 	global.state &= ~WINDOW_LAUNCH_PENDING;
 	g_application_release(G_APPLICATION(global.application));
 	g_printerr("Cannot launch iwgtk window: iwd is not running\n");
     }
+
+    g_free(global.launch_device_path);
+    global.launch_device_path = NULL;
 }
 
 static void config_set_color(GKeyFile *conf, const gchar *group, const gchar *key, GdkRGBA *color) {
@@ -248,16 +388,126 @@ static void config_set_values(GKeyFile *conf) {
 
     global.last_connection_time_fmt = g_key_file_get_string(conf, "known-network", "last-connection-time.format", NULL);
 
+    global.indicator_single_icon = config_get_bool(conf, "indicator", "single-icon", FALSE);
+    global.indicator_throughput = config_get_bool(conf, "indicator", "throughput", FALSE);
+    global.indicator_diagnostics = config_get_bool(conf, "indicator", "diagnostics", FALSE);
+
+    {
+	gint interval;
+
+	interval = config_get_int(conf, "indicator", "tooltip-interval", INDICATOR_TOOLTIP_INTERVAL_DEFAULT);
+
+	if (interval > 0) {
+	    global.indicator_tooltip_interval = interval;
+	}
+	else {
+	    g_printerr("Invalid tooltip interval: %d seconds\n", interval);
+	}
+    }
+
+    {
+	gint *thresholds, *hysteresis;
+	gsize n_thresholds, n_hysteresis;
+
+	thresholds = g_key_file_get_integer_list(conf, "signal", "thresholds", &n_thresholds, NULL);
+	hysteresis = g_key_file_get_integer_list(conf, "signal", "hysteresis", &n_hysteresis, NULL);
+
+	if (!signal_config_set(thresholds, n_thresholds, hysteresis, n_hysteresis, config_get_int(conf, "signal", "dwell", -1))) {
+	    g_printerr("Ignoring invalid [signal] configuration\n");
+	}
+
+	g_free(thresholds);
+	g_free(hysteresis);
+    }
+
     global.width = config_get_int(conf, "window", "width", 440);
     global.height = config_get_int(conf, "window", "height", 600);
 
-    if (config_get_bool(conf, "window", "dark", FALSE)) {
+    if (~global.state & INDICATOR_LIGHT && config_get_bool(conf, "window", "dark", FALSE)) {
 	g_object_set(gtk_settings_get_default(), "gtk-application-prefer-dark-theme", TRUE, NULL);
     }
 
+    global.connect_failover = config_get_bool(conf, "window", "connect-failover", FALSE);
+
     if (config_get_bool(conf, "window", "show-hidden-networks", FALSE)) {
 	global.state |= SHOW_HIDDEN_NETWORKS;
     }
+
+    if (config_get_bool(conf, "window", "background-scan", FALSE)) {
+	gint interval_min, interval_max;
+
+	interval_min = config_get_int(conf, "window", "background-scan-interval-min", 20);
+	interval_max = config_get_int(conf, "window", "background-scan-interval-max", 300);
+
+	if (interval_min > 0 && interval_max >= interval_min) {
+	    global.scan_interval_min = interval_min;
+	    global.scan_interval_max = interval_max;
+	}
+	else {
+	    g_printerr("Invalid background scan interval: %d-%d seconds\n", interval_min, interval_max);
+	}
+    }
+
+    {
+	gint interval;
+
+	interval = config_get_int(conf, "window", "diagnostics-interval", 1000);
+
+	if (interval >= 0) {
+	    global.diagnostic_interval = interval;
+	}
+	else {
+	    g_printerr("Invalid diagnostics interval: %d ms\n", interval);
+	}
+    }
+
+    if (global.recorder == NULL && config_get_bool(conf, "recorder", "enabled", FALSE)) {
+	gchar *path;
+	gint interval, max_size, max_files;
+
+	path = g_key_file_get_string(conf, "recorder", "path", NULL);
+
+	if (path == NULL) {
+	    path = g_build_filename(g_get_user_state_dir(), "iwgtk", "diagnostics.csv", NULL);
+	}
+
+	interval = config_get_int(conf, "recorder", "interval", 10);
+	max_size = config_get_int(conf, "recorder", "max-size", 1024);
+	max_files = config_get_int(conf, "recorder", "max-files", 4);
+
+	if (interval > 0 && max_size > 0 && max_files > 0) {
+	    global.recorder = recorder_new(path, interval, (goffset) max_size * 1024, max_files);
+
+	    // Otherwise, it's started along with the indicator daemon
+	    if (global.state & INDICATOR_DAEMON) {
+		recorder_start(global.recorder);
+	    }
+	}
+	else {
+	    g_printerr("Invalid diagnostics recorder settings\n");
+	}
+
+	g_free(path);
+    }
+
+    {
+	gint interval;
+
+	interval = config_get_int(conf, "survey", "interval", SURVEY_INTERVAL_DEFAULT);
+
+	if (interval > 0) {
+	    global.survey_interval = interval;
+	}
+	else {
+	    g_printerr("Invalid survey interval: %d seconds\n", interval);
+	}
+    }
+
+    if (config_get_bool(conf, "debug", "watchdog", FALSE)) {
+	global.watchdog_threshold = config_get_int(conf, "debug", "watchdog-threshold", 50);
+    }
+
+    global.startup_timing = config_get_bool(conf, "debug", "startup-timing", FALSE);
 }
 
 static gboolean config_read_file(const gchar *path, GKeyFile *key_file) {
@@ -283,7 +533,11 @@ static gboolean config_read_file(const gchar *path, GKeyFile *key_file) {
     return conf_loaded;
 }
 
-static void config_load_attempt() {
+/*
+ * The configuration file is read and parsed in a worker thread, while the
+ * system bus connection is being set up.
+ */
+static void config_load_thread(GTask *task, gpointer source_object, gpointer task_data, GCancellable *cancellable) {
     GKeyFile *key_file;
     gchar *user_conf;
 
@@ -291,24 +545,108 @@ static void config_load_attempt() {
     user_conf = g_strconcat(g_get_user_config_dir(), "/iwgtk.conf", NULL);
 
     if (config_read_file(user_conf, key_file) || config_read_file(SYSCONFDIR "/iwgtk.conf", key_file)) {
-	config_set_values(key_file);
+	g_task_return_pointer(task, key_file, (GDestroyNotify) g_key_file_free);
+    }
+    else {
+	g_key_file_free(key_file);
+	g_task_return_pointer(task, NULL, NULL);
     }
 
     g_free(user_conf);
-    g_key_file_free(key_file);
 }
 
-void startup(GtkApplication *app) {
-    {
-	volatile gsize error_domain_volatile;
+static void config_load_callback(GObject *source_object, GAsyncResult *res, gpointer user_data) {
+    GKeyFile *key_file;
 
-	g_dbus_error_register_error_domain("iwd-error-quark", &error_domain_volatile, iwd_error_codes, G_N_ELEMENTS(iwd_error_codes));
-	global.iwd_error_domain = (GQuark) error_domain_volatile;
+    key_file = g_task_propagate_pointer(G_TASK(res), NULL);
+
+    if (key_file) {
+	config_set_values(key_file);
+	g_key_file_free(key_file);
     }
 
-    icon_theme_set();
-    config_load_attempt();
+    global.state &= ~CONFIG_PENDING;
+    startup_mark(STARTUP_CONFIG);
+
+    if (global.watchdog_threshold > 0) {
+	watchdog_init(global.watchdog_threshold);
+    }
+
+    /*
+     * Indicators which were created before the configuration arrived have been
+     * drawn with the default colors.
+     */
+    indicators_refresh();
+    signal_agents_register();
+
+    if (global.survey) {
+	survey_scan_schedule();
+    }
+
+    window_launch_pending();
+}
+
+static void config_load_attempt() {
+    GTask *task;
+
+    global.state |= CONFIG_PENDING;
+
+    task = g_task_new(NULL, NULL, config_load_callback, NULL);
+    g_task_run_in_thread(task, config_load_thread);
+    g_object_unref(task);
+}
+
+static const gchar* const startup_milestone_names[] = {
+    "application",
+    "iwd-appeared",
+    "config-loaded",
+    "iwd-data"
+};
+
+/*
+ * Records the first time that a startup milestone is reached, relative to the
+ * beginning of main(). Once both the configuration and the first batch of iwd
+ * objects have arrived, the timings are optionally printed.
+ */
+void startup_mark(StartupMilestone milestone) {
+    if (global.startup_times[milestone] != 0) {
+	return;
+    }
 
+    global.startup_times[milestone] = MAX(g_get_monotonic_time() - global.startup_begin, 1);
+
+    if (global.startup_timing && global.startup_times[STARTUP_CONFIG] && global.startup_times[STARTUP_IWD_DATA]) {
+	g_printerr("Startup timing (ms):");
+
+	for (int i = 0; i < N_STARTUP_MILESTONES; i ++) {
+	    if (global.startup_times[i]) {
+		g_printerr(" %s=%.1f", startup_milestone_names[i], global.startup_times[i] / 1000.0);
+	    }
+	}
+
+	g_printerr("\n");
+    }
+}
+
+void startup_collect(GVariantBuilder *builder) {
+    for (int i = 0; i < N_STARTUP_MILESTONES; i ++) {
+	if (global.startup_times[i]) {
+	    gchar *key;
+
+	    key = g_strdup_printf("startup.%s-us", startup_milestone_names[i]);
+	    g_variant_builder_add(builder, "{sv}", key, g_variant_new_uint64(global.startup_times[i]));
+	    g_free(key);
+	}
+    }
+}
+
+void startup(GApplication *app) {
+    startup_mark(STARTUP_APPLICATION);
+
+    /*
+     * Getting hold of iwd takes the longest, so it's started first. Everything
+     * else is done while waiting for the system bus.
+     */
     g_bus_watch_name(
 	G_BUS_TYPE_SYSTEM,
 	IWD_BUS_NAME,
@@ -318,6 +656,27 @@ void startup(GtkApplication *app) {
 	NULL,
 	NULL
     );
+
+    config_load_attempt();
+
+    {
+	volatile gsize error_domain_volatile;
+
+	g_dbus_error_register_error_domain("iwd-error-quark", &error_domain_volatile, iwd_error_codes, G_N_ELEMENTS(iwd_error_codes));
+	global.iwd_error_domain = (GQuark) error_domain_volatile;
+    }
+
+    {
+	GDBusConnection *session_bus;
+
+	session_bus = g_application_get_dbus_connection(G_APPLICATION(app));
+	if (session_bus) {
+	    stats_connection_watch(session_bus, "session");
+	    debug_register(session_bus);
+	}
+    }
+
+    g_unix_signal_add(SIGUSR1, (GSourceFunc) debug_stats_dump, NULL);
 }
 
 gint handle_local_options(GApplication *application, GVariantDict *options) {
@@ -326,9 +685,86 @@ gint handle_local_options(GApplication *application, GVariantDict *options) {
 	return 0;
     }
 
+    if (g_variant_dict_contains(options, "stats")) {
+	return debug_stats_print();
+    }
+
+    {
+	const gchar *path;
+
+	if (g_variant_dict_lookup(options, "survey-export", "^&ay", &path)) {
+	    const gchar *format;
+
+	    format = NULL;
+	    g_variant_dict_lookup(options, "survey-format", "&s", &format);
+	    return survey_export(path, format);
+	}
+
+	if (g_variant_dict_lookup(options, "diagnostics-export", "^&ay", &path)) {
+	    const gchar *format;
+
+	    format = NULL;
+	    g_variant_dict_lookup(options, "diagnostics-format", "&s", &format);
+	    return recorder_export(path, format);
+	}
+    }
+
     return -1;
 }
 
+void indicator_daemon_start() {
+    if (global.state & INDICATOR_DAEMON) {
+	g_printerr("Indicator daemon is already running\n");
+	return;
+    }
+
+    global.state |= INDICATOR_DAEMON;
+    g_application_hold(G_APPLICATION(global.application));
+    indicators_start();
+
+    if (global.recorder != NULL) {
+	recorder_start(global.recorder);
+    }
+}
+
+/*
+ * Launchers which honor DBusActivatable=true call Activate() on the session bus,
+ * rather than starting a new process which then forwards its command line.
+ */
+void activate(GApplication *application) {
+    window_launch();
+}
+
+static void activate_action(GSimpleAction *action, GVariant *parameter, gpointer user_data) {
+    window_launch();
+}
+
+/*
+ * Used by the lightweight indicator daemon, which has no window of its own, to open
+ * the window on the device which was clicked.
+ */
+static void launch_device_action(GSimpleAction *action, GVariant *parameter, gpointer user_data) {
+    if (global.window != NULL) {
+	window_select_device(global.window, g_variant_get_string(parameter, NULL));
+    }
+    else {
+	g_free(global.launch_device_path);
+	global.launch_device_path = g_variant_dup_string(parameter, NULL);
+    }
+
+    window_launch();
+}
+
+static void indicators_action(GSimpleAction *action, GVariant *parameter, gpointer user_data) {
+    indicator_daemon_start();
+}
+
+static const GActionEntry application_actions[] = {
+    {"activate",      activate_action,      NULL, NULL, NULL},
+    {"launch-device", launch_device_action, "s",  NULL, NULL},
+    {"indicators",    indicators_action,    NULL, NULL, NULL}
+};
+
 gint command_line(GApplication *application, GApplicationCommandLine *command_line) {
     GVariantDict *options;
 
@@ -342,18 +778,23 @@ gint command_line(GApplication *application, GApplicationCommandLine *command_li
 	global.state |= NOTIFICATIONS_DISABLE;
     }
 
-    if (g_variant_dict_contains(options, "indicators")) {
-	if (global.state & INDICATOR_DAEMON) {
-	    g_printerr("Indicator daemon is already running\n");
-	}
-	else {
-	    global.state |= INDICATOR_DAEMON;
-	    g_application_hold(application);
+    if (g_variant_dict_contains(options, "indicators") || g_variant_dict_contains(options, "light-indicators")) {
+	indicator_daemon_start();
+    }
+    else if (g_variant_dict_contains(options, "survey")) {
+	const gchar *path;
+	GFile *file;
 
-	    if (global.manager) {
-		add_all_dbus_objects(NULL);
-	    }
+	g_variant_dict_lookup(options, "survey", "^&ay", &path);
+	file = g_application_command_line_create_file_for_arg(command_line, path);
+
+	if (!survey_start(file)) {
+	    g_object_unref(file);
+	    return 1;
 	}
+
+	g_object_unref(file);
+	window_launch();
     }
     else {
 	window_launch();
@@ -362,17 +803,117 @@ gint command_line(GApplication *application, GApplicationCommandLine *command_li
     return 0;
 }
 
+static const GOptionEntry* command_option_find(gchar short_name, const gchar *long_name) {
+    for (const GOptionEntry *entry = command_options; entry->long_name != NULL; entry ++) {
+	if (long_name != NULL ? !strcmp(entry->long_name, long_name) : entry->short_name == short_name) {
+	    return entry;
+	}
+    }
+
+    return NULL;
+}
+
+/*
+ * Looks for -l/--light-indicators the way GOptionContext would find it: within a
+ * bundle of short options, everything after an option which takes an argument is
+ * that argument (as in -S/path/to/file), and such an option at the end of a bundle
+ * consumes the next element of argv.
+ */
+static gboolean light_indicators_requested(int argc, char **argv) {
+    for (int i = 1; i < argc; i ++) {
+	const GOptionEntry *entry;
+
+	if (argv[i][0] != '-' || argv[i][1] == '\0') {
+	    continue;
+	}
+
+	if (argv[i][1] == '-') {
+	    gchar *name, *value;
+
+	    if (argv[i][2] == '\0') {
+		break;
+	    }
+
+	    name = g_strdup(argv[i] + 2);
+	    value = strchr(name, '=');
+
+	    if (value != NULL) {
+		*value = '\0';
+	    }
+
+	    entry = command_option_find('\0', name);
+
+	    if (entry != NULL && entry->arg != G_OPTION_ARG_NONE && value == NULL) {
+		i ++;
+	    }
+
+	    g_free(name);
+
+	    if (entry != NULL && entry->short_name == 'l') {
+		return TRUE;
+	    }
+
+	    continue;
+	}
+
+	for (const gchar *c = argv[i] + 1; *c != '\0'; c ++) {
+	    entry = command_option_find(*c, NULL);
+
+	    if (entry == NULL) {
+		// Unknown to iwgtk; GOptionContext will report it
+		break;
+	    }
+
+	    if (entry->short_name == 'l') {
+		return TRUE;
+	    }
+
+	    if (entry->arg != G_OPTION_ARG_NONE) {
+		if (c[1] == '\0') {
+		    i ++;
+		}
+
+		break;
+	    }
+	}
+    }
+
+    return FALSE;
+}
+
 int main (int argc, char **argv) {
+    global.startup_begin = g_get_monotonic_time();
+
     setlocale(LC_ALL, "");
     bindtextdomain(PACKAGE, LOCALEDIR);
     bind_textdomain_codeset(PACKAGE, "UTF-8");
     textdomain(PACKAGE);
 
-    global.application = gtk_application_new(APPLICATION_ID, G_APPLICATION_HANDLES_COMMAND_LINE);
+    /*
+     * The lightweight indicator daemon has to be chosen before GApplication parses
+     * the command line, since it runs as a plain GApplication (with its own ID), and
+     * GTK is never initialized.
+     */
+    if (light_indicators_requested(argc, argv)) {
+	global.state |= INDICATOR_LIGHT;
+	global.application = g_application_new(APPLICATION_ID_LIGHT, G_APPLICATION_HANDLES_COMMAND_LINE);
+    }
+    else {
+	global.application = G_APPLICATION(gtk_application_new(APPLICATION_ID, G_APPLICATION_HANDLES_COMMAND_LINE));
+    }
 
     g_application_set_option_context_summary(G_APPLICATION(global.application), _("iwgtk is a wireless networking GUI."));
     g_application_add_main_option_entries(G_APPLICATION(global.application), command_options);
 
+    /*
+     * The full application is D-Bus activatable. If it isn't already running, the
+     * session bus starts it with --gapplication-service.
+     */
+    if (~global.state & INDICATOR_LIGHT) {
+	g_action_map_add_action_entries(G_ACTION_MAP(global.application), application_actions, G_N_ELEMENTS(application_actions), NULL);
+	g_signal_connect(global.application, "activate", G_CALLBACK(activate), NULL);
+    }
+
     g_signal_connect(global.application, "startup", G_CALLBACK(startup), NULL);
     g_signal_connect(global.application, "handle-local-options", G_CALLBACK(handle_local_options), NULL);
     g_signal_connect(global.application, "command-line", G_CALLBACK(command_line), NULL);
@@ -381,6 +922,7 @@ int main (int argc, char **argv) {
 	int status;
 
 	status = g_application_run(G_APPLICATION(global.application), argc, argv);
+	connect_latency_flush();
 	g_object_unref(global.application);
 	return status;
     }
@@ -27,26 +27,64 @@ typedef struct GlobalData_s GlobalData;
 #define INDICATOR_DAEMON      (1 << 2)
 #define NOTIFICATIONS_DISABLE (1 << 3)
 #define SHOW_HIDDEN_NETWORKS  (1 << 4)
+#define INDICATOR_LIGHT       (1 << 5)
+#define CONFIG_PENDING        (1 << 6)
+
+typedef enum {
+    STARTUP_APPLICATION,
+    STARTUP_IWD_UP,
+    STARTUP_CONFIG,
+    STARTUP_IWD_DATA,
+    N_STARTUP_MILESTONES
+} StartupMilestone;
 
 struct GlobalData_s {
-    GtkApplication *application;
+    GApplication *application;
     GtkIconTheme *theme;
+    GDBusConnection *system_bus;
+    gchar *iwd_name_owner;
     GDBusObjectManager *manager;
+    IndicatorManager *indicator_manager;
+    IndicatorSummary *indicator_summary;
     GQuark iwd_error_domain;
     Window *window;
     Indicator *indicators;
+    gchar *launch_device_path;
     int width;
     int height;
     guint8 state;
     gchar *last_connection_time_fmt;
+    gboolean indicator_single_icon;
+    guint indicator_tooltip_interval;
+    gboolean indicator_throughput;
+    gboolean indicator_diagnostics;
+    guint scan_interval_min;
+    guint scan_interval_max;
+    guint diagnostic_interval;
+    Survey *survey;
+    Recorder *recorder;
+    Failover *failover;
+    gboolean connect_failover;
+    guint survey_interval;
+    gint watchdog_threshold;
+    gboolean startup_timing;
+    gint64 startup_begin;
+    gint64 startup_times[N_STARTUP_MILESTONES];
 };
 
 extern GlobalData global;
 
+void object_manager_new(GDBusConnection *connection);
 void object_manager_callback(GDBusObjectManagerClient *manager, GAsyncResult *res);
-void iwd_up(GDBusConnection *connection);
+void window_launch_pending();
+void indicators_start();
+void iwd_up(GDBusConnection *connection, const gchar *name, const gchar *name_owner);
 void iwd_down(GDBusConnection *connection);
-void startup(GtkApplication *app);
+void startup_mark(StartupMilestone milestone);
+void startup_collect(GVariantBuilder *builder);
+void startup(GApplication *app);
+void indicator_daemon_start();
+void activate(GApplication *application);
 gint handle_local_options(GApplication *application, GVariantDict *options);
 gint command_line(GApplication *application, GApplicationCommandLine *command_line);
 
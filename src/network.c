@@ -43,9 +43,20 @@ const gchar* get_security_type(const gchar *type_raw) {
     }
 }
 
-void connect_button_clicked(GtkButton *button, GDBusProxy *network_proxy) {
+/*
+ * Connection attempts are timed from the button click to iwd's reply. Clicking
+ * Connect also ends any failover which is in progress.
+ */
+void connect_button_clicked(GtkButton *button, Network *network) {
+    GDBusProxy *network_proxy;
     CallbackMessages *messages;
 
+    network_proxy = network->proxy;
+
+    if (pending_find(network_proxy, "Connect")) {
+	return;
+    }
+
     messages = g_malloc(sizeof(CallbackMessages));
     messages->error_table = detailed_errors_network;
     messages->free = TRUE;
@@ -63,20 +74,43 @@ void connect_button_clicked(GtkButton *button, GDBusProxy *network_proxy) {
 	g_variant_unref(ssid_var);
     }
 
-    g_dbus_proxy_call(
+    failover_cancel();
+    connect_latency_begin(network_proxy);
+
+    pending_call(
 	network_proxy,
 	"Connect",
 	NULL,
-	G_DBUS_CALL_FLAGS_NONE,
-	-1,
-	NULL,
-	(GAsyncReadyCallback) method_call_notify,
-	messages);
+	PENDING_TIMEOUT_CONNECT,
+	(GAsyncReadyCallback) connect_callback,
+	messages,
+	(PendingRefresh) station_networks_set,
+	network->station);
+}
+
+void connect_callback(GDBusProxy *network_proxy, GAsyncResult *res, CallbackMessages *messages) {
+    GError *err;
+
+    err = NULL;
+    method_call_notify_finish(network_proxy, res, messages, &err);
+    connect_latency_end(g_dbus_proxy_get_object_path(network_proxy), err);
+
+    if (err != NULL) {
+	if (global.connect_failover && failover_eligible(err)) {
+	    failover_start(network_proxy);
+	}
+
+	g_error_free(err);
+    }
 }
 
 void disconnect_button_clicked(GtkButton *button, Network *network) {
     CallbackMessages *messages;
 
+    if (pending_find(network->station->proxy, "Disconnect")) {
+	return;
+    }
+
     messages = g_malloc(sizeof(CallbackMessages));
     messages->error_table = NULL;
     messages->free = TRUE;
@@ -94,20 +128,18 @@ void disconnect_button_clicked(GtkButton *button, Network *network) {
 	g_variant_unref(ssid_var);
     }
 
-    g_dbus_proxy_call(
+    pending_call(
 	network->station->proxy,
 	"Disconnect",
 	NULL,
-	G_DBUS_CALL_FLAGS_NONE,
-	-1,
-	NULL,
+	PENDING_TIMEOUT_DEFAULT,
 	(GAsyncReadyCallback) method_call_notify,
-	messages);
+	messages,
+	(PendingRefresh) station_networks_set,
+	network->station);
 }
 
 void network_set(Network *network) {
-    NetworkStatus network_status;
-
     {
 	GVariant *ssid_var;
 	const gchar *ssid;
@@ -150,16 +182,17 @@ void network_set(Network *network) {
 	    }
 
 	    if (network->station->state == STATION_CONNECTED) {
-		network_status = NETWORK_CONNECTED;
+		network->status = NETWORK_CONNECTED;
 		gtk_widget_set_tooltip_text(network->status_icon, _("Connected"));
 	    }
 	    else {
-		network_status = NETWORK_CONNECTING;
+		network->status = NETWORK_CONNECTING;
 		gtk_widget_set_tooltip_text(network->status_icon, _("Connecting"));
 	    }
 
 	    gtk_button_set_label(button, _("Disconnect"));
 	    gtk_widget_set_tooltip_text(network->connect_button, _("Disconnect from network"));
+	    gtk_widget_set_sensitive(network->connect_button, !pending_find(network->station->proxy, "Disconnect"));
 	    network->button_handler_id = g_signal_connect(button, "clicked", G_CALLBACK(disconnect_button_clicked), network);
 	}
 	else {
@@ -170,42 +203,90 @@ void network_set(Network *network) {
 	    }
 
 	    known_network_var = g_dbus_proxy_get_cached_property(network->proxy, "KnownNetwork");
-	    if (known_network_var) {
-		g_variant_unref(known_network_var);
-		network_status = NETWORK_KNOWN;
+	    if (pending_find(network->proxy, "Connect")) {
+		/*
+		 * Show the attempt as soon as the request has been sent, rather
+		 * than waiting for iwd to report it.
+		 */
+		network->status = NETWORK_CONNECTING;
+		gtk_widget_set_tooltip_text(network->status_icon, _("Connecting"));
+	    }
+	    else if (known_network_var) {
+		network->status = NETWORK_KNOWN;
 		gtk_widget_set_tooltip_text(network->status_icon, _("Known network"));
 	    }
 	    else {
-		network_status = NETWORK_UNKNOWN;
+		network->status = NETWORK_UNKNOWN;
 		gtk_widget_set_tooltip_text(network->status_icon, _("Unknown network"));
 	    }
 
+	    if (known_network_var) {
+		g_variant_unref(known_network_var);
+	    }
+
 	    gtk_button_set_label(button, _("Connect"));
 	    gtk_widget_set_tooltip_text(network->connect_button, _("Connect to network"));
-	    network->button_handler_id = g_signal_connect(button, "clicked", G_CALLBACK(connect_button_clicked), network->proxy);
+	    gtk_widget_set_sensitive(network->connect_button, network->status != NETWORK_CONNECTING);
+	    network->button_handler_id = g_signal_connect(button, "clicked", G_CALLBACK(connect_button_clicked), network);
 	}
     }
 
-    {
-	const gchar *icon_name;
+    network_icon_set(network);
+}
 
-	icon_name = station_icons[network->level];
-	symbolic_icon_set_image(icon_name, color_status[network_status], network->status_icon);
+void network_icon_set(Network *network) {
+    symbolic_icon_set_image(signal_level_icon(network->level), color_status[network->status], network->status_icon);
+}
+
+/*
+ * The trend box shows a sparkline of the network's recent signal strength,
+ * followed by its average and trend.
+ */
+static GtkWidget* network_trend_box_new(Network *network) {
+    GtkWidget *box;
+
+    box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+
+    if (network->history) {
+	GtkWidget *sparkline, *average_label;
+
+	sparkline = gtk_drawing_area_new();
+	gtk_drawing_area_set_content_width(GTK_DRAWING_AREA(sparkline), SPARKLINE_WIDTH);
+	gtk_drawing_area_set_content_height(GTK_DRAWING_AREA(sparkline), SPARKLINE_HEIGHT);
+	gtk_widget_set_valign(sparkline, GTK_ALIGN_CENTER);
+	gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(sparkline), (GtkDrawingAreaDrawFunc) signal_history_draw, network->history, NULL);
+
+	{
+	    gchar *summary;
+
+	    summary = signal_history_summary(network->history);
+	    average_label = gtk_label_new(summary);
+	    g_free(summary);
+	}
+
+	gtk_box_append(GTK_BOX(box), sparkline);
+	gtk_box_append(GTK_BOX(box), average_label);
+
+	gtk_widget_set_tooltip_text(box, _("Signal strength in recent scans, with its average and trend"));
     }
+
+    return box;
 }
 
-void station_add_network(Station *station, GDBusProxy *network_proxy, gint16 signal_strength, int index) {
+void station_add_network(Station *station, GDBusProxy *network_proxy, guint8 level, SignalHistory *history, int index) {
     Network *network;
 
     network = station->networks + index;
 
     network->proxy = network_proxy;
     network->station = station;
-    network->level = get_signal_level(signal_strength);
+    network->level = level;
+    network->history = history;
     network->button_handler_id = 0;
 
     network->status_icon = gtk_picture_new();
     network->ssid_label = gtk_label_new(NULL);
+    network->trend_box = network_trend_box_new(network);
     network->security_label = gtk_label_new(NULL);
     network->connect_button = gtk_button_new();
 
@@ -214,16 +295,19 @@ void station_add_network(Station *station, GDBusProxy *network_proxy, gint16 sig
 
     g_object_ref_sink(network->status_icon);
     g_object_ref_sink(network->ssid_label);
+    g_object_ref_sink(network->trend_box);
     g_object_ref_sink(network->security_label);
     g_object_ref_sink(network->connect_button);
 
     gtk_grid_attach(GTK_GRID(station->network_table), network->status_icon,    0, index, 1, 1);
     gtk_grid_attach(GTK_GRID(station->network_table), network->ssid_label,     1, index, 1, 1);
-    gtk_grid_attach(GTK_GRID(station->network_table), network->security_label, 2, index, 1, 1);
-    gtk_grid_attach(GTK_GRID(station->network_table), network->connect_button, 3, index, 1, 1);
+    gtk_grid_attach(GTK_GRID(station->network_table), network->trend_box,      2, index, 1, 1);
+    gtk_grid_attach(GTK_GRID(station->network_table), network->security_label, 3, index, 1, 1);
+    gtk_grid_attach(GTK_GRID(station->network_table), network->connect_button, 4, index, 1, 1);
 
     gtk_widget_set_halign(network->status_icon,    GTK_ALIGN_START);
     gtk_widget_set_halign(network->ssid_label,     GTK_ALIGN_START);
+    gtk_widget_set_halign(network->trend_box,      GTK_ALIGN_END);
     gtk_widget_set_halign(network->security_label, GTK_ALIGN_START);
     gtk_widget_set_halign(network->connect_button, GTK_ALIGN_FILL);
 
@@ -238,6 +322,7 @@ void station_add_network(Station *station, GDBusProxy *network_proxy, gint16 sig
 void network_remove(Network *network) {
     g_object_unref(network->status_icon);
     g_object_unref(network->ssid_label);
+    g_object_unref(network->trend_box);
     g_object_unref(network->security_label);
     g_object_unref(network->connect_button);
 
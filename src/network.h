@@ -34,11 +34,14 @@ struct Network_s {
     GDBusProxy *proxy;
     Station *station;
 
-    gint8 level;
+    guint8 level;
+    NetworkStatus status;
+    SignalHistory *history;
 
     // Widgets
     GtkWidget *status_icon;
     GtkWidget *ssid_label;
+    GtkWidget *trend_box;
     GtkWidget *security_label;
     GtkWidget *connect_button;
 
@@ -48,10 +51,12 @@ struct Network_s {
 };
 
 const gchar* get_security_type(const gchar *type_raw);
-void connect_button_clicked(GtkButton *button, GDBusProxy *network_proxy);
+void connect_button_clicked(GtkButton *button, Network *network);
+void connect_callback(GDBusProxy *network_proxy, GAsyncResult *res, CallbackMessages *messages);
 void disconnect_button_clicked(GtkButton *button, Network *network);
 void network_set(Network *network);
-void station_add_network(Station *station, GDBusProxy *network_proxy, gint16 signal_strength, int index);
+void network_icon_set(Network *network);
+void station_add_network(Station *station, GDBusProxy *network_proxy, guint8 level, SignalHistory *history, int index);
 void network_remove(Network *network);
 
 #endif
@@ -0,0 +1,328 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+/*
+ * "<object path> <interface>.<member>" -> PendingOperation
+ */
+static GHashTable *pending_operations = NULL;
+
+static gchar* pending_key(GDBusProxy *proxy, const gchar *member) {
+    return g_strdup_printf("%s %s.%s", g_dbus_proxy_get_object_path(proxy), g_dbus_proxy_get_interface_name(proxy), member);
+}
+
+static void pending_operation_free(PendingOperation *op) {
+    if (op->handler_update != 0) {
+	g_signal_handler_disconnect(op->proxy, op->handler_update);
+    }
+
+    if (op->settle_id != 0) {
+	g_source_remove(op->settle_id);
+    }
+
+    if (op->value != NULL) {
+	g_variant_unref(op->value);
+    }
+
+    if (op->value_next != NULL) {
+	g_variant_unref(op->value_next);
+    }
+
+    g_object_unref(op->proxy);
+    g_free(op->property);
+    g_free(op->key);
+    g_free(op);
+}
+
+static PendingOperation* pending_operation_new(GDBusProxy *proxy, const gchar *member, gint timeout, PendingRefresh refresh, gpointer refresh_data) {
+    PendingOperation *op;
+
+    if (pending_operations == NULL) {
+	pending_operations = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify) pending_operation_free);
+    }
+
+    op = g_malloc(sizeof(PendingOperation));
+    op->key = pending_key(proxy, member);
+    op->proxy = g_object_ref(proxy);
+    op->property = NULL;
+    op->value = NULL;
+    op->value_next = NULL;
+    op->timeout = timeout;
+    op->callback = NULL;
+    op->user_data = NULL;
+    op->refresh = refresh;
+    op->refresh_data = refresh_data;
+    op->handler_update = 0;
+    op->settle_id = 0;
+
+    g_hash_table_insert(pending_operations, op->key, op);
+    return op;
+}
+
+static PendingOperation* pending_lookup(GDBusProxy *proxy, const gchar *member) {
+    PendingOperation *op;
+    gchar *key;
+
+    if (pending_operations == NULL) {
+	return NULL;
+    }
+
+    key = pending_key(proxy, member);
+    op = g_hash_table_lookup(pending_operations, key);
+    g_free(key);
+
+    return op;
+}
+
+/*
+ * Has the widgets which show the object redraw themselves, taking into account the
+ * operations which are still pending.
+ */
+static void pending_refresh(PendingOperation *op) {
+    if (op->refresh != NULL) {
+	op->refresh(op->refresh_data);
+    }
+}
+
+/*
+ * Removes the operation and shows the object as it actually is. For a failed
+ * operation, this rolls back the optimistic state of its widgets.
+ */
+static void pending_resolve(PendingOperation *op) {
+    g_hash_table_steal(pending_operations, op->key);
+    pending_refresh(op);
+    pending_operation_free(op);
+}
+
+static void pending_call_callback(GDBusProxy *proxy, GAsyncResult *res, PendingOperation *op) {
+    g_hash_table_steal(pending_operations, op->key);
+
+    if (op->callback != NULL) {
+	op->callback(G_OBJECT(proxy), res, op->user_data);
+    }
+
+    pending_refresh(op);
+    pending_operation_free(op);
+}
+
+static gboolean pending_property_settle(PendingOperation *op) {
+    op->settle_id = 0;
+    pending_resolve(op);
+    return G_SOURCE_REMOVE;
+}
+
+static void pending_property_changed(PendingOperation *op) {
+    GVariant *value_cached;
+
+    value_cached = g_dbus_proxy_get_cached_property(op->proxy, op->property);
+
+    if (value_cached != NULL) {
+	if (g_variant_equal(value_cached, op->value)) {
+	    pending_resolve(op);
+	}
+
+	g_variant_unref(value_cached);
+    }
+}
+
+static void pending_property_send(PendingOperation *op);
+
+static void pending_property_callback(GDBusProxy *proxy, GAsyncResult *res, PendingOperation *op) {
+    GVariant *ret;
+    GError *err;
+
+    watchdog_mark("Properties.Set reply (%s)", op->property);
+
+    err = NULL;
+    ret = g_dbus_proxy_call_finish(proxy, res, &err);
+
+    if (ret == NULL) {
+	g_printerr("Failed to set remote property '%s': %s\n", op->property, err->message);
+	g_error_free(err);
+	pending_resolve(op);
+	return;
+    }
+
+    g_variant_unref(ret);
+
+    if (op->value_next != NULL) {
+	g_variant_unref(op->value);
+	op->value = op->value_next;
+	op->value_next = NULL;
+	pending_property_send(op);
+	return;
+    }
+
+    // Wait for the property cache to catch up, unless it already has
+    op->handler_update = g_signal_connect_swapped(proxy, "g-properties-changed", G_CALLBACK(pending_property_changed), op);
+    op->settle_id = g_timeout_add(PENDING_SETTLE_TIMEOUT, (GSourceFunc) pending_property_settle, op);
+    pending_property_changed(op);
+}
+
+static void pending_property_send(PendingOperation *op) {
+    g_dbus_proxy_call(
+	op->proxy,
+	"org.freedesktop.DBus.Properties.Set",
+	g_variant_new("(ssv)", g_dbus_proxy_get_interface_name(op->proxy), op->property, op->value),
+	G_DBUS_CALL_FLAGS_NONE,
+	op->timeout,
+	NULL,
+	(GAsyncReadyCallback) pending_property_callback,
+	op);
+}
+
+/*
+ * Returns TRUE if the given method call or property change is in flight.
+ */
+gboolean pending_find(GDBusProxy *proxy, const gchar *member) {
+    return pending_lookup(proxy, member) != NULL;
+}
+
+/*
+ * Calls a method, unless the same call is already in flight; in that case, the
+ * parameters are consumed and FALSE is returned. The widgets which show the object
+ * are refreshed as soon as the call is sent, and again after its callback has run.
+ */
+gboolean pending_call(GDBusProxy *proxy, const gchar *method, GVariant *parameters, gint timeout, GAsyncReadyCallback callback, gpointer user_data, PendingRefresh refresh, gpointer refresh_data) {
+    PendingOperation *op;
+
+    if (pending_find(proxy, method)) {
+	if (parameters != NULL) {
+	    g_variant_unref(g_variant_ref_sink(parameters));
+	}
+
+	return FALSE;
+    }
+
+    op = pending_operation_new(proxy, method, timeout, refresh, refresh_data);
+    op->callback = callback;
+    op->user_data = user_data;
+
+    g_dbus_proxy_call(
+	proxy,
+	method,
+	parameters,
+	G_DBUS_CALL_FLAGS_NONE,
+	timeout,
+	NULL,
+	(GAsyncReadyCallback) pending_call_callback,
+	op);
+
+    pending_refresh(op);
+    return TRUE;
+}
+
+/*
+ * Changes a property on the user's behalf. Until iwd has confirmed the change,
+ * pending_property_get() returns the new value. A request for the value which is
+ * already in effect, or already on its way, is dropped.
+ */
+void pending_property_set(GDBusProxy *proxy, const gchar *property, GVariant *value, PendingRefresh refresh, gpointer refresh_data) {
+    PendingOperation *op;
+
+    g_variant_ref_sink(value);
+    op = pending_lookup(proxy, property);
+
+    if (op != NULL) {
+	if (g_variant_equal(value, op->value_next != NULL ? op->value_next : op->value)) {
+	    g_variant_unref(value);
+	    return;
+	}
+
+	if (op->handler_update == 0) {
+	    // Still in flight: the new value goes out once iwd has replied
+	    if (op->value_next != NULL) {
+		g_variant_unref(op->value_next);
+		op->value_next = NULL;
+	    }
+
+	    if (g_variant_equal(value, op->value)) {
+		g_variant_unref(value);
+	    }
+	    else {
+		op->value_next = value;
+	    }
+
+	    return;
+	}
+
+	// Confirmed, but not cached yet; the cache can't be trusted
+	g_hash_table_remove(pending_operations, op->key);
+    }
+    else {
+	GVariant *value_cached;
+	gboolean unchanged;
+
+	value_cached = g_dbus_proxy_get_cached_property(proxy, property);
+	unchanged = value_cached != NULL && g_variant_equal(value, value_cached);
+
+	if (value_cached != NULL) {
+	    g_variant_unref(value_cached);
+	}
+
+	if (unchanged) {
+	    g_variant_unref(value);
+	    return;
+	}
+    }
+
+    op = pending_operation_new(proxy, property, PENDING_TIMEOUT_DEFAULT, refresh, refresh_data);
+    op->property = g_strdup(property);
+    op->value = value;
+    pending_property_send(op);
+}
+
+/*
+ * The value which a property has, or is about to have. The caller owns the
+ * returned reference.
+ */
+GVariant* pending_property_get(GDBusProxy *proxy, const gchar *property) {
+    PendingOperation *op;
+
+    op = pending_lookup(proxy, property);
+
+    if (op != NULL) {
+	return g_variant_ref(op->value_next != NULL ? op->value_next : op->value);
+    }
+
+    return g_dbus_proxy_get_cached_property(proxy, property);
+}
+
+/*
+ * Called when the widgets which show an object are destroyed. Their operations
+ * carry on, but nothing is redrawn when they're resolved.
+ */
+void pending_refresh_cancel(gpointer refresh_data) {
+    GHashTableIter iter;
+    PendingOperation *op;
+
+    if (pending_operations == NULL) {
+	return;
+    }
+
+    g_hash_table_iter_init(&iter, pending_operations);
+
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &op)) {
+	if (op->refresh_data == refresh_data) {
+	    op->refresh = NULL;
+	    op->refresh_data = NULL;
+	}
+    }
+}
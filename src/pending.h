@@ -0,0 +1,68 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_PENDING_H
+#define _IWGTK_PENDING_H
+
+#define PENDING_TIMEOUT_DEFAULT 10000
+#define PENDING_TIMEOUT_CONNECT 120000
+#define PENDING_SETTLE_TIMEOUT 2000
+
+typedef struct PendingOperation_s PendingOperation;
+typedef void (*PendingRefresh) (gpointer data);
+
+/*
+ * A method call or property change which iwgtk has sent to iwd, and which hasn't
+ * been resolved yet. Operations are keyed by object path and member, so the same
+ * operation is never in flight twice.
+ *
+ * For a property change, value is the value which has been sent. If the user asks
+ * for another value in the meantime, it's kept in value_next and sent once iwd has
+ * replied; only the most recent request is kept. After a successful reply, the
+ * operation lingers until the property cache catches up, so that the widget doesn't
+ * briefly show the old value.
+ *
+ * Whenever the operation's state changes, refresh is called to redraw the widgets
+ * which show the object.
+ */
+struct PendingOperation_s {
+    gchar *key;
+    GDBusProxy *proxy;
+    gchar *property;
+    GVariant *value;
+    GVariant *value_next;
+    gint timeout;
+
+    GAsyncReadyCallback callback;
+    gpointer user_data;
+
+    PendingRefresh refresh;
+    gpointer refresh_data;
+
+    gulong handler_update;
+    guint settle_id;
+};
+
+gboolean pending_find(GDBusProxy *proxy, const gchar *member);
+gboolean pending_call(GDBusProxy *proxy, const gchar *method, GVariant *parameters, gint timeout, GAsyncReadyCallback callback, gpointer user_data, PendingRefresh refresh, gpointer refresh_data);
+void pending_property_set(GDBusProxy *proxy, const gchar *property, GVariant *value, PendingRefresh refresh, gpointer refresh_data);
+GVariant* pending_property_get(GDBusProxy *proxy, const gchar *property);
+void pending_refresh_cancel(gpointer refresh_data);
+
+#endif
@@ -0,0 +1,673 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <glib/gstdio.h>
+#include "iwgtk.h"
+
+/*
+ * The StationDiagnostic properties documented by iwd. Any others are appended to
+ * the schema when they first appear.
+ */
+static const gchar *const recorder_columns[] = {
+    "ConnectedBss",
+    "Frequency",
+    "Channel",
+    "Security",
+    "RSSI",
+    "AverageRSSI",
+    "RxMode",
+    "RxBitrate",
+    "RxMCS",
+    "TxMode",
+    "TxBitrate",
+    "TxMCS",
+    "InactiveTime",
+    "ExpectedThroughput"
+};
+
+Recorder* recorder_new(const gchar *path, guint interval, goffset max_size, guint max_files) {
+    Recorder *recorder;
+
+    recorder = g_malloc(sizeof(Recorder));
+    recorder->path = g_strdup(path);
+    recorder->interval = interval;
+    recorder->max_size = max_size;
+    recorder->max_files = max_files;
+    recorder->stream = NULL;
+    recorder->size = 0;
+    recorder->timeout_id = 0;
+    recorder->open_mode = RECORDER_OPEN_ROTATE;
+    recorder->retry_delay = RECORDER_RETRY_MIN;
+    recorder->retry_time = 0;
+
+    recorder->columns = g_ptr_array_new_with_free_func(g_free);
+    for (gsize i = 0; i < G_N_ELEMENTS(recorder_columns); i ++) {
+	g_ptr_array_add(recorder->columns, g_strdup(recorder_columns[i]));
+    }
+
+    return recorder;
+}
+
+/*
+ * Only the indicator daemon records, since it runs for as long as the session does.
+ */
+void recorder_start(Recorder *recorder) {
+    if (recorder->timeout_id == 0) {
+	recorder->timeout_id = g_timeout_add_seconds(recorder->interval, (GSourceFunc) recorder_timeout, recorder);
+    }
+}
+
+/*
+ * The station states come from the indicators' object manager, so a sample costs
+ * one method call per connected station.
+ */
+gboolean recorder_timeout(Recorder *recorder) {
+    GHashTableIter iter;
+    const gchar *path;
+    GHashTable *interfaces;
+
+    if (global.indicator_manager == NULL) {
+	return G_SOURCE_CONTINUE;
+    }
+
+    g_hash_table_iter_init(&iter, global.indicator_manager->objects);
+
+    while (g_hash_table_iter_next(&iter, (gpointer *) &path, (gpointer *) &interfaces)) {
+	GDBusProxy *station_proxy;
+	GVariant *state_var;
+	gboolean connected;
+
+	station_proxy = g_hash_table_lookup(interfaces, IWD_IFACE_STATION);
+
+	if (station_proxy == NULL) {
+	    continue;
+	}
+
+	state_var = g_dbus_proxy_get_cached_property(station_proxy, "State");
+	connected = state_var && strcmp(g_variant_get_string(state_var, NULL), "connected") == 0;
+
+	if (state_var) {
+	    g_variant_unref(state_var);
+	}
+
+	if (connected) {
+	    RecorderSample *sample;
+	    GDBusProxy *device_proxy;
+
+	    sample = g_malloc(sizeof(RecorderSample));
+	    sample->recorder = recorder;
+	    sample->timestamp = g_get_real_time();
+	    sample->device = NULL;
+
+	    device_proxy = g_hash_table_lookup(interfaces, IWD_IFACE_DEVICE);
+
+	    if (device_proxy) {
+		GVariant *name_var;
+
+		name_var = g_dbus_proxy_get_cached_property(device_proxy, "Name");
+
+		if (name_var) {
+		    sample->device = g_variant_dup_string(name_var, NULL);
+		    g_variant_unref(name_var);
+		}
+	    }
+
+	    if (sample->device == NULL) {
+		sample->device = g_strdup(path);
+	    }
+
+	    g_dbus_connection_call(
+		global.indicator_manager->connection,
+		global.indicator_manager->name_owner,
+		path,
+		IWD_IFACE_STATION_DIAGNOSTIC,
+		"GetDiagnostics",
+		NULL,
+		G_VARIANT_TYPE("(a{sv})"),
+		G_DBUS_CALL_FLAGS_NONE,
+		-1,
+		NULL,
+		(GAsyncReadyCallback) recorder_sample_callback,
+		sample);
+	}
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+void recorder_sample_callback(GDBusConnection *connection, GAsyncResult *res, RecorderSample *sample) {
+    GVariant *diagnostics;
+    GError *err;
+
+    err = NULL;
+    diagnostics = g_dbus_connection_call_finish(connection, res, &err);
+
+    if (diagnostics) {
+	recorder_write(sample->recorder, sample, diagnostics);
+	g_variant_unref(diagnostics);
+    }
+    else {
+	// The station may have disconnected since it was sampled
+	if (err->domain != global.iwd_error_domain || err->code != IWD_ERROR_NOT_CONNECTED) {
+	    g_printerr("Failed to sample diagnostics of %s: %s\n", sample->device, err->message);
+	}
+
+	g_error_free(err);
+    }
+
+    g_free(sample->device);
+    g_free(sample);
+}
+
+void recorder_write(Recorder *recorder, RecorderSample *sample, GVariant *diagnostics) {
+    GVariant *properties;
+    GString *line;
+
+    properties = g_variant_get_child_value(diagnostics, 0);
+
+    // A new property changes the schema, which calls for a new file
+    {
+	GVariantIter iter;
+	const gchar *property;
+	gboolean schema_changed;
+
+	schema_changed = FALSE;
+	g_variant_iter_init(&iter, properties);
+
+	while (g_variant_iter_next(&iter, "{&sv}", &property, NULL)) {
+	    if (!g_ptr_array_find_with_equal_func(recorder->columns, property, g_str_equal, NULL)) {
+		g_ptr_array_add(recorder->columns, g_strdup(property));
+		schema_changed = TRUE;
+	    }
+	}
+
+	if (schema_changed) {
+	    if (recorder->stream) {
+		g_output_stream_close(G_OUTPUT_STREAM(recorder->stream), NULL, NULL);
+		g_clear_object(&recorder->stream);
+	    }
+
+	    recorder->open_mode = RECORDER_OPEN_ROTATE;
+	}
+    }
+
+    if (!recorder->stream && (g_get_monotonic_time() < recorder->retry_time || !recorder_open(recorder))) {
+	g_variant_unref(properties);
+	return;
+    }
+
+    line = g_string_new(NULL);
+
+    {
+	gchar *time_str;
+
+	time_str = timestamp_format(sample->timestamp);
+	g_string_append_printf(line, "%s,", time_str);
+	g_free(time_str);
+    }
+
+    csv_field_append(line, sample->device);
+
+    // Strings are quoted and numbers aren't, so that the export can tell them apart
+    for (guint i = 0; i < recorder->columns->len; i ++) {
+	GVariant *value;
+
+	g_string_append_c(line, ',');
+	value = g_variant_lookup_value(properties, g_ptr_array_index(recorder->columns, i), NULL);
+
+	if (value) {
+	    gint64 number;
+
+	    if (diagnostic_value_numeric(value, &number)) {
+		g_string_append_printf(line, "%" G_GINT64_FORMAT, number);
+	    }
+	    else if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING)) {
+		csv_field_append(line, g_variant_get_string(value, NULL));
+	    }
+	    else {
+		gchar *value_str;
+
+		value_str = g_variant_print(value, FALSE);
+		csv_field_append(line, value_str);
+		g_free(value_str);
+	    }
+
+	    g_variant_unref(value);
+	}
+    }
+
+    g_string_append_c(line, '\n');
+
+    {
+	GError *err;
+
+	err = NULL;
+
+	if (g_output_stream_write_all(G_OUTPUT_STREAM(recorder->stream), line->str, line->len, NULL, NULL, &err)) {
+	    recorder->size += line->len;
+
+	    if (recorder->size >= recorder->max_size) {
+		g_output_stream_close(G_OUTPUT_STREAM(recorder->stream), NULL, NULL);
+		g_clear_object(&recorder->stream);
+		recorder->open_mode = RECORDER_OPEN_ROTATE;
+	    }
+	}
+	else {
+	    g_printerr("Failed to write to diagnostics recording: %s\n", err->message);
+	    g_error_free(err);
+	    g_clear_object(&recorder->stream);
+
+	    // The file already has its header, and is continued
+	    recorder->open_mode = RECORDER_OPEN_APPEND;
+	    recorder_retry(recorder);
+	}
+    }
+
+    g_string_free(line, TRUE);
+    g_variant_unref(properties);
+}
+
+/*
+ * Schedules the next attempt to open the file, backing off exponentially.
+ */
+void recorder_retry(Recorder *recorder) {
+    recorder->retry_time = g_get_monotonic_time() + (gint64) recorder->retry_delay * G_USEC_PER_SEC;
+    recorder->retry_delay = MIN(recorder->retry_delay * 2, RECORDER_RETRY_MAX);
+}
+
+/*
+ * A new file begins with its header, and an existing file is rotated out of the way
+ * first. A file which was cut short by a write error is continued or rewritten
+ * instead, so that retries never rotate away the history.
+ */
+gboolean recorder_open(Recorder *recorder) {
+    GFile *file;
+    GError *err;
+
+    {
+	gchar *dir;
+
+	dir = g_path_get_dirname(recorder->path);
+	g_mkdir_with_parents(dir, 0700);
+	g_free(dir);
+    }
+
+    if (recorder->open_mode == RECORDER_OPEN_ROTATE) {
+	if (g_file_test(recorder->path, G_FILE_TEST_EXISTS)) {
+	    recorder_rotate(recorder->path, recorder->max_files);
+	}
+
+	recorder->open_mode = RECORDER_OPEN_REPLACE;
+    }
+    else if (recorder->open_mode == RECORDER_OPEN_APPEND && !g_file_test(recorder->path, G_FILE_TEST_EXISTS)) {
+	recorder->open_mode = RECORDER_OPEN_REPLACE;
+    }
+
+    file = g_file_new_for_path(recorder->path);
+    err = NULL;
+
+    if (recorder->open_mode == RECORDER_OPEN_APPEND) {
+	recorder->stream = g_file_append_to(file, G_FILE_CREATE_PRIVATE, NULL, &err);
+    }
+    else {
+	recorder->stream = g_file_replace(file, NULL, FALSE, G_FILE_CREATE_PRIVATE, NULL, &err);
+    }
+
+    g_object_unref(file);
+
+    if (recorder->stream == NULL) {
+	g_printerr("Failed to open diagnostics recording '%s': %s\n", recorder->path, err->message);
+	g_error_free(err);
+	recorder_retry(recorder);
+	return FALSE;
+    }
+
+    if (recorder->open_mode == RECORDER_OPEN_REPLACE) {
+	GString *header;
+
+	header = g_string_new("time,device");
+
+	for (guint i = 0; i < recorder->columns->len; i ++) {
+	    g_string_append_printf(header, ",%s", (const gchar *) g_ptr_array_index(recorder->columns, i));
+	}
+
+	g_string_append_c(header, '\n');
+	recorder->size = header->len;
+
+	if (!g_output_stream_write_all(G_OUTPUT_STREAM(recorder->stream), header->str, header->len, NULL, NULL, &err)) {
+	    g_printerr("Failed to write to diagnostics recording: %s\n", err->message);
+	    g_error_free(err);
+	    g_clear_object(&recorder->stream);
+	    recorder_retry(recorder);
+	}
+
+	g_string_free(header, TRUE);
+    }
+
+    if (recorder->stream != NULL) {
+	recorder->open_mode = RECORDER_OPEN_APPEND;
+	recorder->retry_delay = RECORDER_RETRY_MIN;
+    }
+
+    return recorder->stream != NULL;
+}
+
+/*
+ * path becomes path.1, path.1 becomes path.2, and so on. Beyond max_files (at least
+ * 1), the oldest file is deleted.
+ */
+void recorder_rotate(const gchar *path, guint max_files) {
+    gchar *from, *to;
+
+    to = g_strdup_printf("%s.%u", path, max_files);
+    g_remove(to);
+
+    for (guint i = max_files; i > 1; i --) {
+	from = g_strdup_printf("%s.%u", path, i - 1);
+	g_rename(from, to);
+	g_free(to);
+	to = from;
+    }
+
+    g_rename(path, to);
+    g_free(to);
+}
+
+/*
+ * Parse one CSV record starting at *cursor, and advance the cursor to the next one.
+ * For each field, whether it was quoted is recorded as well.
+ */
+static gboolean csv_record_next(const gchar **cursor, GPtrArray *fields, GArray *quoted) {
+    const gchar *c;
+
+    g_ptr_array_set_size(fields, 0);
+    g_array_set_size(quoted, 0);
+    c = *cursor;
+
+    if (*c == '\0') {
+	return FALSE;
+    }
+
+    while (TRUE) {
+	GString *field;
+	gboolean field_quoted;
+
+	field = g_string_new(NULL);
+	field_quoted = (*c == '"');
+
+	if (field_quoted) {
+	    c ++;
+
+	    while (*c != '\0') {
+		if (*c == '"') {
+		    if (c[1] != '"') {
+			c ++;
+			break;
+		    }
+
+		    c ++;
+		}
+
+		g_string_append_c(field, *c);
+		c ++;
+	    }
+	}
+
+	while (*c != '\0' && *c != ',' && *c != '\n') {
+	    g_string_append_c(field, *c);
+	    c ++;
+	}
+
+	g_ptr_array_add(fields, g_string_free(field, FALSE));
+	g_array_append_val(quoted, field_quoted);
+
+	if (*c == ',') {
+	    c ++;
+	}
+	else {
+	    if (*c == '\n') {
+		c ++;
+	    }
+
+	    break;
+	}
+    }
+
+    *cursor = c;
+    return TRUE;
+}
+
+static void json_value_append(GString *json, const gchar *value, gboolean quoted) {
+    gint64 number;
+
+    if (!quoted && g_ascii_string_to_signed(value, 10, G_MININT64, G_MAXINT64, &number, NULL)) {
+	g_string_append(json, value);
+    }
+    else {
+	json_string_append(json, value);
+    }
+}
+
+/*
+ * Write a recording and its rotated files to stdout, oldest first. The CSV header
+ * is the union of the files' headers.
+ */
+gint recorder_export(const gchar *path, const gchar *format) {
+    GPtrArray *contents;
+    GPtrArray *columns;
+    GHashTable *column_index;
+    GPtrArray *fields;
+    GArray *quoted;
+    GString *line;
+    gboolean json, first;
+
+    if (format == NULL || strcmp(format, "csv") == 0) {
+	json = FALSE;
+    }
+    else if (strcmp(format, "json") == 0) {
+	json = TRUE;
+    }
+    else {
+	g_printerr("Unknown diagnostics export format: %s\n", format);
+	return 1;
+    }
+
+    contents = g_ptr_array_new_with_free_func(g_free);
+
+    {
+	guint n_rotated;
+
+	n_rotated = 0;
+
+	while (TRUE) {
+	    gchar *rotated_path;
+	    gboolean exists;
+
+	    rotated_path = g_strdup_printf("%s.%u", path, n_rotated + 1);
+	    exists = g_file_test(rotated_path, G_FILE_TEST_EXISTS);
+	    g_free(rotated_path);
+
+	    if (!exists) {
+		break;
+	    }
+
+	    n_rotated ++;
+	}
+
+	for (guint i = n_rotated + 1; i > 0; i --) {
+	    gchar *file_path;
+	    gchar *file_contents;
+	    GError *err;
+
+	    file_path = (i == 1) ? g_strdup(path) : g_strdup_printf("%s.%u", path, i - 1);
+	    err = NULL;
+
+	    if (g_file_get_contents(file_path, &file_contents, NULL, &err)) {
+		g_ptr_array_add(contents, file_contents);
+	    }
+	    else if (i == 1 && n_rotated == 0) {
+		g_printerr("Failed to read diagnostics recording: %s\n", err->message);
+		g_error_free(err);
+		g_free(file_path);
+		g_ptr_array_unref(contents);
+		return 1;
+	    }
+	    else {
+		g_error_free(err);
+	    }
+
+	    g_free(file_path);
+	}
+    }
+
+    fields = g_ptr_array_new_with_free_func(g_free);
+    quoted = g_array_new(FALSE, FALSE, sizeof(gboolean));
+    columns = g_ptr_array_new_with_free_func(g_free);
+    column_index = g_hash_table_new(g_str_hash, g_str_equal);
+
+    for (guint i = 0; i < contents->len; i ++) {
+	const gchar *cursor;
+
+	cursor = g_ptr_array_index(contents, i);
+
+	if (csv_record_next(&cursor, fields, quoted)) {
+	    for (guint j = 0; j < fields->len; j ++) {
+		if (!g_hash_table_contains(column_index, g_ptr_array_index(fields, j))) {
+		    gchar *column;
+
+		    column = g_strdup(g_ptr_array_index(fields, j));
+		    g_hash_table_insert(column_index, column, GUINT_TO_POINTER(columns->len));
+		    g_ptr_array_add(columns, column);
+		}
+	    }
+	}
+    }
+
+    line = g_string_new(NULL);
+    first = TRUE;
+
+    if (json) {
+	puts("[");
+    }
+    else {
+	for (guint i = 0; i < columns->len; i ++) {
+	    g_string_append_printf(line, i == 0 ? "%s" : ",%s", (const gchar *) g_ptr_array_index(columns, i));
+	}
+
+	puts(line->str);
+    }
+
+    for (guint i = 0; i < contents->len; i ++) {
+	const gchar *cursor;
+	GPtrArray *header;
+	gchar **row;
+	gboolean *row_quoted;
+
+	cursor = g_ptr_array_index(contents, i);
+	header = g_ptr_array_new_with_free_func(g_free);
+
+	if (csv_record_next(&cursor, fields, quoted)) {
+	    for (guint j = 0; j < fields->len; j ++) {
+		g_ptr_array_add(header, g_strdup(g_ptr_array_index(fields, j)));
+	    }
+	}
+
+	row = g_malloc(columns->len * sizeof(gchar *));
+	row_quoted = g_malloc(columns->len * sizeof(gboolean));
+
+	while (csv_record_next(&cursor, fields, quoted)) {
+	    g_string_truncate(line, 0);
+
+	    if (json) {
+		gboolean first_field;
+
+		g_string_append(line, first ? "  {" : ",\n  {");
+		first_field = TRUE;
+
+		for (guint j = 0; j < fields->len && j < header->len; j ++) {
+		    const gchar *value;
+
+		    value = g_ptr_array_index(fields, j);
+
+		    if (*value == '\0' && !g_array_index(quoted, gboolean, j)) {
+			continue;
+		    }
+
+		    if (!first_field) {
+			g_string_append(line, ", ");
+		    }
+
+		    json_string_append(line, g_ptr_array_index(header, j));
+		    g_string_append(line, ": ");
+		    json_value_append(line, value, g_array_index(quoted, gboolean, j));
+		    first_field = FALSE;
+		}
+
+		g_string_append_c(line, '}');
+		fputs(line->str, stdout);
+	    }
+	    else {
+		for (guint j = 0; j < columns->len; j ++) {
+		    row[j] = NULL;
+		}
+
+		for (guint j = 0; j < fields->len && j < header->len; j ++) {
+		    guint column;
+
+		    column = GPOINTER_TO_UINT(g_hash_table_lookup(column_index, g_ptr_array_index(header, j)));
+		    row[column] = g_ptr_array_index(fields, j);
+		    row_quoted[column] = g_array_index(quoted, gboolean, j);
+		}
+
+		for (guint j = 0; j < columns->len; j ++) {
+		    if (j > 0) {
+			g_string_append_c(line, ',');
+		    }
+
+		    if (row[j] && row_quoted[j]) {
+			csv_field_append(line, row[j]);
+		    }
+		    else if (row[j]) {
+			g_string_append(line, row[j]);
+		    }
+		}
+
+		puts(line->str);
+	    }
+
+	    first = FALSE;
+	}
+
+	g_free(row);
+	g_free(row_quoted);
+	g_ptr_array_unref(header);
+    }
+
+    if (json) {
+	puts(first ? "]" : "\n]");
+    }
+
+    g_string_free(line, TRUE);
+    g_hash_table_unref(column_index);
+    g_ptr_array_unref(columns);
+    g_array_unref(quoted);
+    g_ptr_array_unref(fields);
+    g_ptr_array_unref(contents);
+    return 0;
+}
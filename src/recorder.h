@@ -0,0 +1,80 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_RECORDER_H
+#define _IWGTK_RECORDER_H
+
+#define RECORDER_RETRY_MIN 10
+#define RECORDER_RETRY_MAX 3600
+
+typedef struct Recorder_s Recorder;
+typedef struct RecorderSample_s RecorderSample;
+
+/*
+ * How the next file is opened. A file is only rotated out of the way once it has
+ * been completed; after a write error, the same file is continued or rewritten.
+ */
+typedef enum {
+    RECORDER_OPEN_ROTATE,
+    RECORDER_OPEN_REPLACE,
+    RECORDER_OPEN_APPEND
+} RecorderOpenMode;
+
+/*
+ * Samples the diagnostics of every connected station into a CSV file, which is
+ * rotated once it exceeds max_size bytes. The columns of a file never change:
+ * if a sample has a property which isn't in the schema, the property is added and
+ * a new file is started.
+ *
+ * If the file can't be opened, samples are dropped until retry_time, and the delay
+ * doubles with every consecutive failure.
+ */
+struct Recorder_s {
+    gchar *path;
+    guint interval;
+    goffset max_size;
+    guint max_files;
+
+    GFileOutputStream *stream;
+    goffset size;
+    GPtrArray *columns;
+    guint timeout_id;
+
+    RecorderOpenMode open_mode;
+    guint retry_delay;
+    gint64 retry_time;
+};
+
+struct RecorderSample_s {
+    Recorder *recorder;
+    gint64 timestamp;
+    gchar *device;
+};
+
+Recorder* recorder_new(const gchar *path, guint interval, goffset max_size, guint max_files);
+void recorder_start(Recorder *recorder);
+gboolean recorder_timeout(Recorder *recorder);
+void recorder_sample_callback(GDBusConnection *connection, GAsyncResult *res, RecorderSample *sample);
+void recorder_write(Recorder *recorder, RecorderSample *sample, GVariant *diagnostics);
+void recorder_retry(Recorder *recorder);
+gboolean recorder_open(Recorder *recorder);
+void recorder_rotate(const gchar *path, guint max_files);
+gint recorder_export(const gchar *path, const gchar *format);
+
+#endif
@@ -0,0 +1,275 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+GDBusArgInfo arg_device = {-1, "device", "o", NULL};
+GDBusArgInfo arg_level = {-1, "level", "y", NULL};
+
+GDBusInterfaceInfo signal_agent_interface_info = {
+    -1,
+    IWD_IFACE_SIGNAL_LEVEL_AGENT,
+    (GDBusMethodInfo *[]) {
+	&(GDBusMethodInfo) {
+	    -1,
+	    "Release",
+	    (GDBusArgInfo *[]) {&arg_device, NULL},
+	    NULL,
+	    NULL
+	},
+	&(GDBusMethodInfo) {
+	    -1,
+	    "Changed",
+	    (GDBusArgInfo *[]) {&arg_device, &arg_level, NULL},
+	    NULL,
+	    NULL
+	},
+	NULL
+    },
+    NULL, // Signal info
+    NULL, // Property info
+    NULL  // Annotation info
+};
+
+GDBusInterfaceVTable signal_agent_interface_vtable = {
+    (GDBusInterfaceMethodCallFunc) signal_agent_method_call_handler,
+    NULL,
+    NULL
+};
+
+/*
+ * Station object path -> SignalAgent
+ */
+static GHashTable *signal_agents = NULL;
+
+static void signal_agent_free(SignalAgent *agent) {
+    g_slist_free_full(agent->subscribers, g_free);
+    g_object_unref(agent->proxy);
+    g_free(agent->path);
+    g_free(agent);
+}
+
+static void signal_agent_register(SignalAgent *agent) {
+    GError *err;
+    static const gchar *agent_error_msg = "Failed to register signal level agent: %s\n";
+
+    err = NULL;
+    agent->registration_id = worker_register_object(
+	g_dbus_proxy_get_connection(agent->proxy),
+	agent->path,
+	&signal_agent_interface_info,
+	&signal_agent_interface_vtable,
+	NULL,
+	NULL,
+	&err);
+
+    if (err != NULL) {
+	g_printerr(agent_error_msg, err->message);
+	g_error_free(err);
+	return;
+    }
+
+    g_dbus_proxy_call(
+	agent->proxy,
+	"RegisterSignalLevelAgent",
+	g_variant_new("(o@an)", agent->path, signal_agent_levels_new()),
+	G_DBUS_CALL_FLAGS_NONE,
+	-1,
+	NULL,
+	(GAsyncReadyCallback) method_call_log,
+	(gpointer) agent_error_msg);
+}
+
+/*
+ * A new subscriber immediately receives the last level that iwd reported. The
+ * agent is only registered once the configuration, which holds the signal
+ * thresholds, has been loaded.
+ */
+void signal_agent_subscribe(GDBusProxy *station_proxy, SignalAgentCallback callback, gpointer user_data) {
+    SignalAgent *agent;
+    SignalAgentSubscriber *subscriber;
+    const gchar *path;
+
+    if (signal_agents == NULL) {
+	signal_agents = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify) signal_agent_free);
+    }
+
+    path = g_dbus_proxy_get_object_path(station_proxy);
+    agent = g_hash_table_lookup(signal_agents, path);
+
+    if (agent == NULL) {
+	agent = g_malloc(sizeof(SignalAgent));
+	agent->path = g_strdup(path);
+	agent->proxy = g_object_ref(station_proxy);
+	agent->registration_id = 0;
+	agent->level = SIGNAL_LEVEL_UNKNOWN;
+	agent->subscribers = NULL;
+	g_hash_table_insert(signal_agents, agent->path, agent);
+    }
+
+    subscriber = g_malloc(sizeof(SignalAgentSubscriber));
+    subscriber->callback = callback;
+    subscriber->user_data = user_data;
+    agent->subscribers = g_slist_append(agent->subscribers, subscriber);
+
+    if (agent->level != SIGNAL_LEVEL_UNKNOWN) {
+	guint8 level_min, level_max;
+
+	signal_agent_level_range(agent->level, &level_min, &level_max);
+	callback(level_min, level_max, user_data);
+    }
+
+    if (agent->registration_id == 0 && (~global.state & CONFIG_PENDING)) {
+	signal_agent_register(agent);
+    }
+}
+
+void signal_agent_unsubscribe(const gchar *path, SignalAgentCallback callback, gpointer user_data) {
+    SignalAgent *agent;
+
+    if (signal_agents == NULL || (agent = g_hash_table_lookup(signal_agents, path)) == NULL) {
+	return;
+    }
+
+    for (GSList *i = agent->subscribers; i != NULL; i = i->next) {
+	SignalAgentSubscriber *subscriber;
+
+	subscriber = i->data;
+
+	if (subscriber->callback == callback && subscriber->user_data == user_data) {
+	    agent->subscribers = g_slist_delete_link(agent->subscribers, i);
+	    g_free(subscriber);
+	    break;
+	}
+    }
+
+    if (agent->subscribers != NULL) {
+	return;
+    }
+
+    if (agent->registration_id != 0) {
+	g_dbus_connection_unregister_object(g_dbus_proxy_get_connection(agent->proxy), agent->registration_id);
+
+	/*
+	 * If the station itself is gone, iwd has already dropped the agent, and
+	 * this call fails harmlessly.
+	 */
+	g_dbus_proxy_call(
+	    agent->proxy,
+	    "UnregisterSignalLevelAgent",
+	    g_variant_new("(o)", agent->path),
+	    G_DBUS_CALL_FLAGS_NONE,
+	    -1,
+	    NULL,
+	    NULL,
+	    NULL);
+    }
+
+    g_hash_table_remove(signal_agents, path);
+}
+
+/*
+ * Registers the agents which have been waiting for the configuration.
+ */
+void signal_agents_register() {
+    GHashTableIter iter;
+    SignalAgent *agent;
+
+    if (signal_agents == NULL) {
+	return;
+    }
+
+    g_hash_table_iter_init(&iter, signal_agents);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &agent)) {
+	if (agent->registration_id == 0) {
+	    signal_agent_register(agent);
+	}
+    }
+}
+
+guint signal_agents_count() {
+    return signal_agents ? g_hash_table_size(signal_agents) : 0;
+}
+
+/*
+ * Runs on the worker thread: iwd gets its reply straight away, and the level is
+ * handed to the main thread.
+ */
+void signal_agent_method_call_handler(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *parameters, GDBusMethodInvocation *invocation, gpointer user_data) {
+    SignalLevelUpdate *update;
+
+    if (strcmp(method_name, "Changed") == 0) {
+	update = g_malloc(sizeof(SignalLevelUpdate));
+	update->release = FALSE;
+	g_variant_get(parameters, "(oy)", NULL, &update->level);
+    }
+    else if (strcmp(method_name, "Release") == 0) {
+	update = g_malloc(sizeof(SignalLevelUpdate));
+	update->release = TRUE;
+	update->level = SIGNAL_LEVEL_UNKNOWN;
+    }
+    else {
+	g_dbus_method_invocation_return_dbus_error(invocation, "org.freedesktop.DBus.Error.UnknownMethod", "Unknown method");
+	return;
+    }
+
+    g_dbus_method_invocation_return_value(invocation, NULL);
+
+    update->path = g_strdup(object_path);
+    g_main_context_invoke(NULL, (GSourceFunc) signal_level_update, update);
+}
+
+gboolean signal_level_update(SignalLevelUpdate *update) {
+    SignalAgent *agent;
+
+    watchdog_mark("SignalLevelAgent.%s %s", update->release ? "Release" : "Changed", update->path);
+
+    agent = signal_agents ? g_hash_table_lookup(signal_agents, update->path) : NULL;
+
+    /*
+     * The agent may have been unsubscribed while this update was in flight.
+     */
+    if (agent != NULL && agent->registration_id != 0) {
+	if (update->release) {
+	    g_dbus_connection_unregister_object(g_dbus_proxy_get_connection(agent->proxy), agent->registration_id);
+	    agent->registration_id = 0;
+	    agent->level = SIGNAL_LEVEL_UNKNOWN;
+	}
+	else if (update->level < signal_agent_n_levels()) {
+	    guint8 level_min, level_max;
+
+	    agent->level = update->level;
+	    signal_agent_level_range(update->level, &level_min, &level_max);
+
+	    for (GSList *i = agent->subscribers; i != NULL; i = i->next) {
+		SignalAgentSubscriber *subscriber;
+
+		subscriber = i->data;
+		subscriber->callback(level_min, level_max, subscriber->user_data);
+	    }
+	}
+	else {
+	    g_printerr("Invalid signal level received\n");
+	}
+    }
+
+    g_free(update->path);
+    g_free(update);
+    return G_SOURCE_REMOVE;
+}
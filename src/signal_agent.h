@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_SIGNAL_AGENT_H
+#define _IWGTK_SIGNAL_AGENT_H
+
+typedef struct SignalAgent_s SignalAgent;
+typedef struct SignalAgentSubscriber_s SignalAgentSubscriber;
+typedef struct SignalLevelUpdate_s SignalLevelUpdate;
+
+typedef void (*SignalAgentCallback) (guint8 level_min, guint8 level_max, gpointer user_data);
+
+/*
+ * iwd accepts a single SignalLevelAgent per station, so the indicator and the window
+ * share one registration. It's released when the last subscriber goes away.
+ */
+struct SignalAgent_s {
+    gchar *path;
+    GDBusProxy *proxy;
+    guint registration_id;
+    guint8 level;
+    GSList *subscribers;
+};
+
+struct SignalAgentSubscriber_s {
+    SignalAgentCallback callback;
+    gpointer user_data;
+};
+
+/*
+ * A SignalLevelAgent call, passed from the worker thread to the main thread.
+ */
+struct SignalLevelUpdate_s {
+    gchar *path;
+    guint8 level;
+    gboolean release;
+};
+
+void signal_agent_subscribe(GDBusProxy *station_proxy, SignalAgentCallback callback, gpointer user_data);
+void signal_agent_unsubscribe(const gchar *path, SignalAgentCallback callback, gpointer user_data);
+void signal_agents_register();
+guint signal_agents_count();
+
+void signal_agent_method_call_handler(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *parameters, GDBusMethodInvocation *invocation, gpointer user_data);
+gboolean signal_level_update(SignalLevelUpdate *update);
+
+#endif
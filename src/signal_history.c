@@ -0,0 +1,171 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+/*
+ * Move a network's history from the previous scan's table into the current one, or
+ * start a new history. Once the current table is full, NULL is returned, which
+ * caps the memory used no matter how many networks are in range.
+ */
+SignalHistory* signal_history_carry(GHashTable *history_old, GHashTable *history_new, const gchar *path) {
+    SignalHistory *history;
+    gchar *key;
+
+    if (g_hash_table_size(history_new) >= SIGNAL_HISTORY_MAX_NETWORKS) {
+	return NULL;
+    }
+
+    if (!g_hash_table_steal_extended(history_old, path, (gpointer *) &key, (gpointer *) &history)) {
+	key = g_strdup(path);
+	history = g_malloc(sizeof(SignalHistory));
+	history->head = 0;
+	history->n_samples = 0;
+    }
+
+    history->missed = 0;
+    g_hash_table_insert(history_new, key, history);
+    return history;
+}
+
+/*
+ * Networks which were missing from the current scan stay in the table for a few
+ * more scans, if there is room. The rest are freed along with the old table.
+ */
+void signal_history_evict(GHashTable *history_old, GHashTable *history_new) {
+    GHashTableIter iter;
+    gchar *key;
+    SignalHistory *history;
+
+    g_hash_table_iter_init(&iter, history_old);
+
+    while (g_hash_table_iter_next(&iter, (gpointer *) &key, (gpointer *) &history)) {
+	if (g_hash_table_size(history_new) >= SIGNAL_HISTORY_MAX_NETWORKS) {
+	    break;
+	}
+
+	if (++ history->missed <= SIGNAL_HISTORY_GRACE) {
+	    g_hash_table_iter_steal(&iter);
+	    g_hash_table_insert(history_new, key, history);
+	}
+    }
+}
+
+void signal_history_add(SignalHistory *history, gint16 signal_strength) {
+    if (history->n_samples < SIGNAL_HISTORY_LEN) {
+	history->samples[(history->head + history->n_samples) % SIGNAL_HISTORY_LEN] = signal_strength;
+	history->n_samples ++;
+    }
+    else {
+	history->samples[history->head] = signal_strength;
+	history->head = (history->head + 1) % SIGNAL_HISTORY_LEN;
+    }
+}
+
+gint16 signal_history_sample(const SignalHistory *history, guint i) {
+    return history->samples[(history->head + i) % SIGNAL_HISTORY_LEN];
+}
+
+static gint signal_history_mean(const SignalHistory *history, guint begin, guint end) {
+    gint sum;
+
+    sum = 0;
+
+    for (guint i = begin; i < end; i ++) {
+	sum += signal_history_sample(history, i);
+    }
+
+    return sum / (gint) (end - begin);
+}
+
+gint16 signal_history_average(const SignalHistory *history) {
+    return signal_history_mean(history, 0, history->n_samples);
+}
+
+/*
+ * Compare the mean of the newer half of the samples against that of the older half.
+ */
+SignalTrend signal_history_trend(const SignalHistory *history) {
+    guint half;
+    gint delta;
+
+    if (history->n_samples < 4) {
+	return SIGNAL_TREND_STEADY;
+    }
+
+    half = history->n_samples / 2;
+    delta = signal_history_mean(history, history->n_samples - half, history->n_samples) - signal_history_mean(history, 0, half);
+
+    if (delta >= SIGNAL_TREND_THRESHOLD) {
+	return SIGNAL_TREND_RISING;
+    }
+    else if (delta <= -SIGNAL_TREND_THRESHOLD) {
+	return SIGNAL_TREND_FALLING;
+    }
+    else {
+	return SIGNAL_TREND_STEADY;
+    }
+}
+
+gchar* signal_history_summary(const SignalHistory *history) {
+    static const gchar *const trend_arrows[] = {"↘", "→", "↗"};
+
+    if (history == NULL || history->n_samples == 0) {
+	return g_strdup("");
+    }
+
+    return g_strdup_printf("%d dBm %s",
+	(signal_history_average(history) - 50) / 100,
+	trend_arrows[signal_history_trend(history)]);
+}
+
+void signal_history_draw(GtkDrawingArea *area, cairo_t *cr, int width, int height, SignalHistory *history) {
+    GdkRGBA color;
+    double step;
+
+    if (history->n_samples < 2) {
+	return;
+    }
+
+    gtk_widget_get_color(GTK_WIDGET(area), &color);
+    gdk_cairo_set_source_rgba(cr, &color);
+    cairo_set_line_width(cr, 1.5);
+    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+
+    // The newest sample is at the right edge
+    step = (double) (width - 2) / (SIGNAL_HISTORY_LEN - 1);
+
+    for (guint i = 0; i < history->n_samples; i ++) {
+	gint16 signal_strength;
+	double x, y;
+
+	signal_strength = CLAMP(signal_history_sample(history, i), SPARKLINE_STRENGTH_MIN, SPARKLINE_STRENGTH_MAX);
+	x = width - 1 - (history->n_samples - 1 - i) * step;
+	y = 1 + (double) (SPARKLINE_STRENGTH_MAX - signal_strength) / (SPARKLINE_STRENGTH_MAX - SPARKLINE_STRENGTH_MIN) * (height - 2);
+
+	if (i == 0) {
+	    cairo_move_to(cr, x, y);
+	}
+	else {
+	    cairo_line_to(cr, x, y);
+	}
+    }
+
+    cairo_stroke(cr);
+}
@@ -0,0 +1,62 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_SIGNAL_HISTORY_H
+#define _IWGTK_SIGNAL_HISTORY_H
+
+#define SIGNAL_HISTORY_LEN 16
+#define SIGNAL_HISTORY_MAX_NETWORKS 64
+#define SIGNAL_HISTORY_GRACE 3
+#define SIGNAL_TREND_THRESHOLD 200
+
+#define SPARKLINE_WIDTH 48
+#define SPARKLINE_HEIGHT 16
+#define SPARKLINE_STRENGTH_MIN (-9000)
+#define SPARKLINE_STRENGTH_MAX (-3000)
+
+typedef struct SignalHistory_s SignalHistory;
+
+typedef enum {
+    SIGNAL_TREND_FALLING,
+    SIGNAL_TREND_STEADY,
+    SIGNAL_TREND_RISING
+} SignalTrend;
+
+/*
+ * The signal strengths (in 100 * dBm) of a network in its most recent scans,
+ * oldest first, starting at samples[head]. A network which drops out of the
+ * scan results is kept for SIGNAL_HISTORY_GRACE scans.
+ */
+struct SignalHistory_s {
+    gint16 samples[SIGNAL_HISTORY_LEN];
+    guint8 head;
+    guint8 n_samples;
+    guint8 missed;
+};
+
+SignalHistory* signal_history_carry(GHashTable *history_old, GHashTable *history_new, const gchar *path);
+void signal_history_evict(GHashTable *history_old, GHashTable *history_new);
+void signal_history_add(SignalHistory *history, gint16 signal_strength);
+gint16 signal_history_sample(const SignalHistory *history, guint i);
+gint16 signal_history_average(const SignalHistory *history);
+SignalTrend signal_history_trend(const SignalHistory *history);
+gchar* signal_history_summary(const SignalHistory *history);
+void signal_history_draw(GtkDrawingArea *area, cairo_t *cr, int width, int height, SignalHistory *history);
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+SignalConfig signal_config = {
+    4,
+    {-60, -67, -74, -81},
+    {2, 2, 2, 2},
+    2000
+};
+
+/*
+ * Validates and applies the [signal] configuration. Thresholds must be descending,
+ * and the dead-bands of neighboring thresholds must not overlap. A single hysteresis
+ * value applies to every threshold.
+ */
+gboolean signal_config_set(const gint *thresholds, gsize n_thresholds, const gint *hysteresis, gsize n_hysteresis, gint dwell) {
+    SignalConfig config;
+
+    if (thresholds != NULL) {
+	if (n_thresholds == 0 || n_thresholds > MAX_SIGNAL_THRESHOLDS) {
+	    g_printerr("Between 1 and %d signal thresholds may be configured\n", MAX_SIGNAL_THRESHOLDS);
+	    return FALSE;
+	}
+
+	config.n_thresholds = n_thresholds;
+	for (gsize i = 0; i < n_thresholds; i ++) {
+	    config.thresholds[i] = thresholds[i];
+	}
+    }
+    else {
+	config.n_thresholds = signal_config.n_thresholds;
+	memcpy(config.thresholds, signal_config.thresholds, sizeof(config.thresholds));
+    }
+
+    if (hysteresis != NULL) {
+	if (n_hysteresis != 1 && n_hysteresis != config.n_thresholds) {
+	    g_printerr("Signal hysteresis must be a single value, or one value per threshold\n");
+	    return FALSE;
+	}
+
+	for (guint i = 0; i < config.n_thresholds; i ++) {
+	    config.hysteresis[i] = hysteresis[n_hysteresis == 1 ? 0 : i];
+	}
+    }
+    else {
+	for (guint i = 0; i < config.n_thresholds; i ++) {
+	    config.hysteresis[i] = signal_config.hysteresis[MIN(i, MAX_SIGNAL_THRESHOLDS - 1)];
+	}
+    }
+
+    for (guint i = 0; i < config.n_thresholds; i ++) {
+	if (config.thresholds[i] > 0 || config.thresholds[i] < -120) {
+	    g_printerr("Invalid signal threshold: %d dBm\n", config.thresholds[i]);
+	    return FALSE;
+	}
+
+	if (config.hysteresis[i] < 0 || config.hysteresis[i] > 20) {
+	    g_printerr("Invalid signal hysteresis: %d dB\n", config.hysteresis[i]);
+	    return FALSE;
+	}
+
+	if (i > 0 && config.thresholds[i - 1] - config.hysteresis[i - 1] <= config.thresholds[i] + config.hysteresis[i]) {
+	    g_printerr("Signal thresholds must be descending, with non-overlapping hysteresis\n");
+	    return FALSE;
+	}
+    }
+
+    config.dwell = dwell >= 0 ? dwell : signal_config.dwell;
+    signal_config = config;
+    return TRUE;
+}
+
+static guint8 signal_level_offset(gint16 signal_strength, gint sign) {
+    guint8 i;
+
+    for (i = 0; i < signal_config.n_thresholds; i ++) {
+	if (signal_strength > 100*(signal_config.thresholds[i] + sign*signal_config.hysteresis[i])) {
+	    return i;
+	}
+    }
+
+    return signal_config.n_thresholds;
+}
+
+/*
+ * Maps a signal strength, in units of 100 dBm, onto a level.
+ */
+guint8 signal_level_get(gint16 signal_strength) {
+    return signal_level_offset(signal_strength, 0);
+}
+
+/*
+ * Like signal_level_get(), except that the previous level is kept for as long as
+ * the signal is within the dead-band of the threshold between the levels.
+ */
+guint8 signal_level_hysteresis(gint16 signal_strength, guint8 previous) {
+    if (previous == SIGNAL_LEVEL_UNKNOWN) {
+	return signal_level_get(signal_strength);
+    }
+
+    return CLAMP(previous, signal_level_offset(signal_strength, -1), signal_level_offset(signal_strength, 1));
+}
+
+/*
+ * There are always five signal icons, however many thresholds are configured.
+ */
+const gchar* signal_level_icon(guint8 level) {
+    if (level > signal_config.n_thresholds) {
+	level = signal_config.n_thresholds;
+    }
+
+    return station_icons[(level * (N_STATION_ICONS - 1) + signal_config.n_thresholds / 2) / signal_config.n_thresholds];
+}
+
+/*
+ * The SignalLevelAgent is registered with both edges of each dead-band, so that iwd
+ * reports which side of each edge the signal is on. Edges which coincide (with zero
+ * hysteresis) are only registered once.
+ */
+GVariant* signal_agent_levels_new() {
+    GVariantBuilder builder;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("an"));
+
+    for (guint i = 0; i < signal_config.n_thresholds; i ++) {
+	g_variant_builder_add(&builder, "n", signal_config.thresholds[i] + signal_config.hysteresis[i]);
+
+	if (signal_config.hysteresis[i] > 0) {
+	    g_variant_builder_add(&builder, "n", signal_config.thresholds[i] - signal_config.hysteresis[i]);
+	}
+    }
+
+    return g_variant_builder_end(&builder);
+}
+
+guint8 signal_agent_n_levels() {
+    guint8 n;
+
+    n = 1;
+    for (guint i = 0; i < signal_config.n_thresholds; i ++) {
+	n += signal_config.hysteresis[i] > 0 ? 2 : 1;
+    }
+
+    return n;
+}
+
+/*
+ * Translates a level reported by iwd into the range of levels that it's consistent
+ * with. Inside a dead-band, either of the neighboring levels is.
+ */
+void signal_agent_level_range(guint8 agent_level, guint8 *level_min, guint8 *level_max) {
+    guint8 edge;
+
+    edge = 0;
+    for (guint8 i = 0; i < signal_config.n_thresholds; i ++) {
+	if (agent_level == edge) {
+	    *level_min = *level_max = i;
+	    return;
+	}
+
+	edge ++;
+
+	if (signal_config.hysteresis[i] > 0) {
+	    if (agent_level == edge) {
+		*level_min = i;
+		*level_max = i + 1;
+		return;
+	    }
+
+	    edge ++;
+	}
+    }
+
+    *level_min = *level_max = signal_config.n_thresholds;
+}
+
+void signal_filter_init(SignalFilter *filter, SignalFilterCallback callback, gpointer user_data) {
+    filter->level = SIGNAL_LEVEL_UNKNOWN;
+    filter->pending = SIGNAL_LEVEL_UNKNOWN;
+    filter->timeout_id = 0;
+    filter->callback = callback;
+    filter->user_data = user_data;
+}
+
+void signal_filter_clear(SignalFilter *filter) {
+    if (filter->timeout_id != 0) {
+	g_source_remove(filter->timeout_id);
+	filter->timeout_id = 0;
+    }
+
+    filter->level = SIGNAL_LEVEL_UNKNOWN;
+    filter->pending = SIGNAL_LEVEL_UNKNOWN;
+}
+
+void signal_filter_update(SignalFilter *filter, guint8 level_min, guint8 level_max) {
+    guint8 level;
+
+    if (filter->level == SIGNAL_LEVEL_UNKNOWN) {
+	// The first report is shown straight away
+	signal_filter_clear(filter);
+	filter->level = level_min;
+	filter->callback(filter->level, filter->user_data);
+	return;
+    }
+
+    level = CLAMP(filter->level, level_min, level_max);
+
+    if (level == filter->level) {
+	// A brief excursion has ended before the dwell time was up
+	if (filter->timeout_id != 0) {
+	    g_source_remove(filter->timeout_id);
+	    filter->timeout_id = 0;
+	}
+	return;
+    }
+
+    if (signal_config.dwell == 0) {
+	filter->level = level;
+	filter->callback(filter->level, filter->user_data);
+	return;
+    }
+
+    if (filter->timeout_id != 0) {
+	if (filter->pending == level) {
+	    return;
+	}
+
+	g_source_remove(filter->timeout_id);
+    }
+
+    filter->pending = level;
+    filter->timeout_id = g_timeout_add(signal_config.dwell, (GSourceFunc) signal_filter_timeout, filter);
+}
+
+gboolean signal_filter_timeout(SignalFilter *filter) {
+    filter->timeout_id = 0;
+    filter->level = filter->pending;
+    filter->callback(filter->level, filter->user_data);
+    return G_SOURCE_REMOVE;
+}
@@ -0,0 +1,72 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_SIGNAL_LEVEL_H
+#define _IWGTK_SIGNAL_LEVEL_H
+
+#define MAX_SIGNAL_THRESHOLDS 4
+#define SIGNAL_LEVEL_UNKNOWN  G_MAXUINT8
+
+typedef struct SignalConfig_s SignalConfig;
+typedef struct SignalFilter_s SignalFilter;
+
+typedef void (*SignalFilterCallback) (guint8 level, gpointer user_data);
+
+/*
+ * Thresholds are in dBm, in descending order. Level 0 is the strongest signal, and
+ * level n_thresholds is the weakest. A level only changes once the signal is more
+ * than hysteresis[i] dB past threshold i.
+ */
+struct SignalConfig_s {
+    guint n_thresholds;
+    gint16 thresholds[MAX_SIGNAL_THRESHOLDS];
+    gint16 hysteresis[MAX_SIGNAL_THRESHOLDS];
+    guint dwell;
+};
+
+/*
+ * Smooths a stream of signal level reports. A new level is only shown after the
+ * reports have held it for the configured dwell time.
+ */
+struct SignalFilter_s {
+    guint8 level;
+    guint8 pending;
+    guint timeout_id;
+    SignalFilterCallback callback;
+    gpointer user_data;
+};
+
+extern SignalConfig signal_config;
+
+gboolean signal_config_set(const gint *thresholds, gsize n_thresholds, const gint *hysteresis, gsize n_hysteresis, gint dwell);
+
+guint8 signal_level_get(gint16 signal_strength);
+guint8 signal_level_hysteresis(gint16 signal_strength, guint8 previous);
+const gchar* signal_level_icon(guint8 level);
+
+GVariant* signal_agent_levels_new();
+guint8 signal_agent_n_levels();
+void signal_agent_level_range(guint8 agent_level, guint8 *level_min, guint8 *level_max);
+
+void signal_filter_init(SignalFilter *filter, SignalFilterCallback callback, gpointer user_data);
+void signal_filter_clear(SignalFilter *filter);
+void signal_filter_update(SignalFilter *filter, guint8 level_min, guint8 level_max);
+gboolean signal_filter_timeout(SignalFilter *filter);
+
+#endif
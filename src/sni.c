@@ -242,6 +242,11 @@ StatusNotifierItem* sni_new(gpointer user_data) {
 }
 
 void sni_rm(StatusNotifierItem *sni) {
+    if (sni->icon_cancellable != NULL) {
+	g_cancellable_cancel(sni->icon_cancellable);
+	g_object_unref(sni->icon_cancellable);
+    }
+
     g_bus_unown_name(sni->owner_id);
     g_dbus_connection_unregister_object(sni->connection, sni->registration_id);
 
@@ -370,6 +375,8 @@ void validate_method_call(GDBusConnection *connection, GAsyncResult *res, const
 }
 
 void sni_method_call(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *parameters, GDBusMethodInvocation *invocation, StatusNotifierItem *sni) {
+    watchdog_mark("StatusNotifierItem.%s", method_name);
+
     if (strcmp(method_name, "ContextMenu") == 0) {
 	if (sni->context_menu_handler != NULL) {
 	    sni->context_menu_handler(sni->user_data);
@@ -420,6 +427,8 @@ void sni_method_call(GDBusConnection *connection, const gchar *sender, const gch
 }
 
 GVariant* sni_get_property(GDBusConnection *connection, const gchar *sender, const gchar *object_path, const gchar *interface_name, const gchar *property_name, GError **error, StatusNotifierItem *sni) {
+    watchdog_mark("StatusNotifierItem.Get(%s)", property_name);
+
     if (strcmp(property_name, "Category") == 0) {
 	if (sni->category) {
 	    return g_variant_ref(sni->category);
@@ -536,18 +545,26 @@ gboolean sni_abstract_icon_pixmap_set(GVariant **sni_icon_pixmap, cairo_surface_
 
 	cairo_surface_flush(surface);
 
+	/*
+	 * The surface may be shared with the icon cache, so the byte order is
+	 * converted in a copy rather than in place.
+	 */
 	if (G_BYTE_ORDER == G_LITTLE_ENDIAN) {
 	    guint32 *argb32;
 
-	    argb32 = (guint32 *) argb;
+	    argb32 = g_malloc(4*n);
 	    for (int i = 0; i < n; i ++) {
-		argb32[i] = g_htonl(argb32[i]);
+		argb32[i] = g_htonl(((guint32 *) argb)[i]);
 	    }
+
+	    tuple[2] = g_variant_new_from_data(G_VARIANT_TYPE_BYTESTRING, argb32, 4*n, TRUE, g_free, argb32);
+	}
+	else {
+	    tuple[2] = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, argb, 4*n, 1);
 	}
 
 	tuple[0] = g_variant_new_int32(width);
 	tuple[1] = g_variant_new_int32(height);
-	tuple[2] = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, argb, 4*n, 1);
 
 	cairo_surface_destroy(surface);
     }
@@ -681,3 +698,28 @@ void sni_attention_movie_name_set(StatusNotifierItem *sni, const gchar *attentio
     sni->attention_movie_name = g_variant_new_string(attention_movie_name);
     g_variant_ref_sink(sni->attention_movie_name);
 }
+
+/*
+ * Sets a tooltip without an icon of its own. NewToolTip is only emitted if the text
+ * has changed.
+ */
+void sni_tooltip_set(StatusNotifierItem *sni, const gchar *title, const gchar *description) {
+    if (sni->tooltip != NULL) {
+	const gchar *title_old, *description_old;
+
+	g_variant_get(sni->tooltip, "(&sa(iiay)&s&s)", NULL, NULL, &title_old, &description_old);
+
+	if (!strcmp(title, title_old) && !strcmp(description, description_old)) {
+	    return;
+	}
+
+	g_variant_unref(sni->tooltip);
+    }
+
+    sni->tooltip = g_variant_new("(sa(iiay)ss)", "", NULL, title, description);
+    g_variant_ref_sink(sni->tooltip);
+
+    if (sni->connection) {
+	sni_emit_signal(sni, "NewToolTip", NULL);
+    }
+}
@@ -68,6 +68,9 @@ struct StatusNotifierItem_s {
     GVariant *tooltip;
     gboolean item_is_menu;
     GVariant *menu;
+
+    // Icon which is being rendered
+    GCancellable *icon_cancellable;
 };
 
 StatusNotifierItem* sni_new(gpointer user_data);
@@ -93,5 +96,6 @@ void sni_overlay_icon_pixmap_set(StatusNotifierItem *sni, cairo_surface_t *surfa
 void sni_attention_icon_name_set(StatusNotifierItem *sni, const gchar *attention_icon_name);
 void sni_attention_icon_pixmap_set(StatusNotifierItem *sni, cairo_surface_t *surface);
 void sni_attention_movie_name_set(StatusNotifierItem *sni, const gchar *attention_movie_name);
+void sni_tooltip_set(StatusNotifierItem *sni, const gchar *title, const gchar *description);
 
 #endif
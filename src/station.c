@@ -85,6 +85,11 @@ Station* station_add(Window *window, GDBusObject *object, GDBusProxy *proxy) {
     station->state = STATION_SCANNING;
     station->n_networks = 0;
     station->network_connected = NULL;
+    station->network_levels = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    station->network_history = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    station->scan_interval = global.scan_interval_min;
+    station->scan_timeout_id = 0;
+    station->scan_cancellable = NULL;
 
     station->scan_button = gtk_button_new();
     g_object_ref_sink(station->scan_button);
@@ -142,11 +147,30 @@ Station* station_add(Window *window, GDBusObject *object, GDBusProxy *proxy) {
     station->handler_update = g_signal_connect_swapped(proxy, "g-properties-changed", G_CALLBACK(station_set), station);
     station_set(station);
 
+    /*
+     * Background scans only run while the network list is on screen.
+     */
+    if (global.scan_interval_max > 0) {
+	station->map_handler = g_signal_connect_swapped(station->network_table, "map", G_CALLBACK(station_scan_schedule), station);
+	station->unmap_handler = g_signal_connect_swapped(station->network_table, "unmap", G_CALLBACK(station_scan_unschedule), station);
+    }
+    else {
+	station->map_handler = 0;
+	station->unmap_handler = 0;
+    }
+
+    /*
+     * Live signal levels for the connected network. If the indicator daemon runs
+     * in this process, it shares the agent.
+     */
+    signal_agent_subscribe(proxy, (SignalAgentCallback) station_signal_agent_changed, station);
+
     return station;
 }
 
 void station_remove(Window *window, Station *station) {
     g_signal_handler_disconnect(station->proxy, station->handler_update);
+    pending_refresh_cancel(station);
 
     couple_unregister(window, DEVICE_STATION, 1, station);
     couple_unregister(window, STATION_DPP,    0, station);
@@ -162,12 +186,47 @@ void station_remove(Window *window, Station *station) {
     g_object_unref(station->provision_menu);
     g_object_unref(station->provision_vbox);
 
+    signal_agent_unsubscribe(g_dbus_proxy_get_object_path(station->proxy), (SignalAgentCallback) station_signal_agent_changed, station);
+
+    if (station->map_handler != 0) {
+	g_signal_handler_disconnect(station->network_table, station->map_handler);
+	g_signal_handler_disconnect(station->network_table, station->unmap_handler);
+    }
+
+    station_scan_unschedule(station);
+
+    if (station->scan_cancellable != NULL) {
+	g_cancellable_cancel(station->scan_cancellable);
+	g_object_unref(station->scan_cancellable);
+    }
+
     station_network_table_clear(station);
     g_object_unref(station->network_table);
+    g_hash_table_unref(station->network_levels);
+    g_hash_table_unref(station->network_history);
 
     g_free(station);
 }
 
+void station_signal_agent_changed(guint8 level_min, guint8 level_max, Station *station) {
+    Network *network;
+    guint8 level;
+
+    network = station->network_connected;
+
+    if (network == NULL) {
+	return;
+    }
+
+    level = CLAMP(network->level, level_min, level_max);
+
+    if (level != network->level) {
+	network->level = level;
+	g_hash_table_insert(station->network_levels, g_strdup(g_dbus_proxy_get_object_path(network->proxy)), GUINT_TO_POINTER(level + 1));
+	network_icon_set(network);
+    }
+}
+
 void bind_device_station(Device *device, Station *station) {
     gtk_grid_attach(GTK_GRID(device->table), station->scan_button,      3, 0, 1, 1);
     gtk_grid_attach(GTK_GRID(device->table), station->provision_button, 3, 1, 1, 1);
@@ -192,6 +251,123 @@ void send_scan_request(Station *station) {
 	"Scan request failed: %s\n");
 }
 
+void station_scan_schedule(Station *station) {
+    station_scan_unschedule(station);
+
+    if (global.scan_interval_max > 0 && gtk_widget_get_mapped(station->network_table)) {
+	station->scan_timeout_id = g_timeout_add_seconds(station->scan_interval, (GSourceFunc) station_scan_timeout, station);
+    }
+}
+
+void station_scan_unschedule(Station *station) {
+    if (station->scan_timeout_id != 0) {
+	g_source_remove(station->scan_timeout_id);
+	station->scan_timeout_id = 0;
+    }
+}
+
+/*
+ * Requests a background scan, unless one is already underway or the window is
+ * minimized. The timer is restarted when the results come in.
+ */
+gboolean station_scan_timeout(Station *station) {
+    station->scan_timeout_id = 0;
+
+    {
+	GdkSurface *surface;
+
+	surface = gtk_native_get_surface(gtk_widget_get_native(station->network_table));
+
+	if (GDK_IS_TOPLEVEL(surface) && (gdk_toplevel_get_state(GDK_TOPLEVEL(surface)) & GDK_TOPLEVEL_STATE_MINIMIZED)) {
+	    station_scan_schedule(station);
+	    return G_SOURCE_REMOVE;
+	}
+    }
+
+    // A site survey has its own, fixed scan cadence
+    if (station->state == STATION_SCANNING || station->scan_cancellable != NULL || global.survey) {
+	station_scan_schedule(station);
+	return G_SOURCE_REMOVE;
+    }
+
+    station->scan_cancellable = g_cancellable_new();
+
+    g_dbus_proxy_call(
+	station->proxy,
+	"Scan",
+	NULL,
+	G_DBUS_CALL_FLAGS_NONE,
+	-1,
+	station->scan_cancellable,
+	(GAsyncReadyCallback) station_scan_callback,
+	station);
+
+    return G_SOURCE_REMOVE;
+}
+
+void station_scan_callback(GDBusProxy *proxy, GAsyncResult *res, Station *station) {
+    GVariant *ret;
+    GError *err;
+
+    err = NULL;
+    ret = g_dbus_proxy_call_finish(proxy, res, &err);
+
+    if (ret == NULL) {
+	if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+	    g_error_free(err);
+	    return;
+	}
+
+	// iwd may be busy, e.g. connecting; just try again later
+	if (err->domain != global.iwd_error_domain || err->code != IWD_ERROR_BUSY) {
+	    g_printerr("Background scan request failed: %s\n", err->message);
+	}
+
+	g_error_free(err);
+	station_scan_schedule(station);
+    }
+    else {
+	g_variant_unref(ret);
+    }
+
+    g_object_unref(station->scan_cancellable);
+    station->scan_cancellable = NULL;
+}
+
+/*
+ * Backs off when consecutive scans return (nearly) the same networks at the same
+ * levels, and speeds up when they churn.
+ */
+void station_scan_adapt(Station *station, GHashTable *network_levels) {
+    GHashTableIter iter;
+    gpointer path, level;
+    guint changes, total;
+
+    changes = 0;
+    total = MAX(g_hash_table_size(network_levels), g_hash_table_size(station->network_levels));
+
+    g_hash_table_iter_init(&iter, network_levels);
+    while (g_hash_table_iter_next(&iter, &path, &level)) {
+	if (g_hash_table_lookup(station->network_levels, path) != level) {
+	    changes ++;
+	}
+    }
+
+    g_hash_table_iter_init(&iter, station->network_levels);
+    while (g_hash_table_iter_next(&iter, &path, NULL)) {
+	if (!g_hash_table_contains(network_levels, path)) {
+	    changes ++;
+	}
+    }
+
+    if (changes * 10 <= total) {
+	station->scan_interval = MIN(station->scan_interval * 2, global.scan_interval_max);
+    }
+    else if (changes * 10 >= total * 3) {
+	station->scan_interval = MAX(station->scan_interval / 2, global.scan_interval_min);
+    }
+}
+
 void insert_separator(Station *station, gint position) {
     GtkWidget *separator;
 
@@ -230,10 +406,22 @@ void station_network_table_clear(Station *station) {
     }
 }
 
+/*
+ * Redraws the station's networks, e.g. to show a Connect or Disconnect call which
+ * is in flight.
+ */
+void station_networks_set(Station *station) {
+    for (gsize i = 0; i < station->n_networks; i ++) {
+	network_set(station->networks + i);
+    }
+}
+
 void get_networks_callback(GDBusProxy *proxy, GAsyncResult *res, Station *station) {
     GVariant *ordered_networks;
     GError *err;
 
+    watchdog_mark("GetOrderedNetworks reply");
+
     err = NULL;
     ordered_networks = g_dbus_proxy_call_finish(proxy, res, &err);
 
@@ -241,9 +429,13 @@ void get_networks_callback(GDBusProxy *proxy, GAsyncResult *res, Station *statio
 	GVariantIter *iter;
 	const gchar *network_path;
 	gint16 signal_strength;
+	GHashTable *network_levels;
+	GHashTable *network_history;
 	gint i;
 
 	g_variant_get(ordered_networks, "(a(on))", &iter);
+	network_levels = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	network_history = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 
 	station->n_networks = g_variant_iter_n_children(iter);
 	station->networks = g_malloc(station->n_networks * sizeof(Network));
@@ -255,13 +447,46 @@ void get_networks_callback(GDBusProxy *proxy, GAsyncResult *res, Station *statio
 	    network_proxy = G_DBUS_PROXY(g_dbus_object_manager_get_interface(global.manager, network_path, IWD_IFACE_NETWORK));
 
 	    if (network_proxy) {
-		station_add_network(station, network_proxy, signal_strength, i ++);
+		guint8 level;
+		SignalHistory *history;
+
+		/*
+		 * Apply hysteresis against the level that the network had in the
+		 * previous list, so that its icon doesn't flap between scans.
+		 */
+		level = GPOINTER_TO_UINT(g_hash_table_lookup(station->network_levels, network_path));
+		level = signal_level_hysteresis(signal_strength, level == 0 ? SIGNAL_LEVEL_UNKNOWN : level - 1);
+		g_hash_table_insert(network_levels, g_strdup(network_path), GUINT_TO_POINTER(level + 1));
+
+		history = signal_history_carry(station->network_history, network_history, network_path);
+
+		if (history) {
+		    signal_history_add(history, signal_strength);
+		}
+
+		station_add_network(station, network_proxy, level, history, i ++);
 	    }
 	    else {
 		g_printerr("Failed to find network object '%s'\n", network_path);
 	    }
 	}
 
+	if (global.survey) {
+	    survey_record_networks(proxy, ordered_networks);
+	}
+
+	if (global.scan_interval_max > 0) {
+	    station_scan_adapt(station, network_levels);
+	    station_scan_schedule(station);
+	}
+
+	g_hash_table_unref(station->network_levels);
+	station->network_levels = network_levels;
+
+	signal_history_evict(station->network_history, network_history);
+	g_hash_table_unref(station->network_history);
+	station->network_history = network_history;
+
 	if (station->n_networks > 0) {
 	    insert_separator(station, station->n_networks);
 	}
@@ -274,7 +499,7 @@ void get_networks_callback(GDBusProxy *proxy, GAsyncResult *res, Station *statio
 	g_error_free(err);
     }
 
-    if (global.state & SHOW_HIDDEN_NETWORKS) {
+    if (global.state & SHOW_HIDDEN_NETWORKS || global.survey) {
 	g_dbus_proxy_call(
 	    proxy,
 	    "GetHiddenAccessPoints",
@@ -291,10 +516,20 @@ void get_hidden_networks_callback(GDBusProxy *proxy, GAsyncResult *res, Station
     GVariant *ordered_networks;
     GError *err;
 
+    watchdog_mark("GetHiddenAccessPoints reply");
+
     err = NULL;
     ordered_networks = g_dbus_proxy_call_finish(proxy, res, &err);
 
-    if (ordered_networks) {
+    if (ordered_networks && global.survey) {
+	survey_record_hidden(proxy, ordered_networks);
+    }
+
+    // In survey mode, hidden networks are retrieved even if they aren't shown
+    if (ordered_networks && ~global.state & SHOW_HIDDEN_NETWORKS) {
+	g_variant_unref(ordered_networks);
+    }
+    else if (ordered_networks) {
 	gint i;
 	GVariantIter *iter;
 	const gchar *address;
@@ -45,6 +45,19 @@ struct Station_s {
     Network *networks;
     Network *network_connected;
 
+    // Network object path -> signal level + 1, from the previous network list
+    GHashTable *network_levels;
+
+    // Network object path -> SignalHistory
+    GHashTable *network_history;
+
+    // Background scans
+    guint scan_interval;
+    guint scan_timeout_id;
+    GCancellable *scan_cancellable;
+    gulong map_handler;
+    gulong unmap_handler;
+
     // Widgets
     GtkWidget *scan_button;
     GtkWidget *scan_widget_idle;
@@ -63,10 +76,17 @@ void station_remove(Window *window, Station *station);
 void bind_device_station(Device *device, Station *station);
 void unbind_device_station(Device *device, Station *station);
 
+void station_signal_agent_changed(guint8 level_min, guint8 level_max, Station *station);
 void send_scan_request(Station *station);
+void station_scan_schedule(Station *station);
+void station_scan_unschedule(Station *station);
+gboolean station_scan_timeout(Station *station);
+void station_scan_callback(GDBusProxy *proxy, GAsyncResult *res, Station *station);
+void station_scan_adapt(Station *station, GHashTable *network_levels);
 void insert_separator(Station *station, gint position);
 void station_network_table_build(Station *station);
 void station_network_table_clear(Station *station);
+void station_networks_set(Station *station);
 void get_networks_callback(GDBusProxy *proxy, GAsyncResult *res, Station *station);
 void get_hidden_networks_callback(GDBusProxy *proxy, GAsyncResult *res, Station *station);
 
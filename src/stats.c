@@ -0,0 +1,463 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+/*
+ * GDBus invokes message filters from its worker thread, so every piece of state in
+ * this file is protected by stats_mutex.
+ */
+
+static GMutex stats_mutex;
+static GSList *stats_connections = NULL;
+
+void histogram_add(Histogram *histogram, gint64 usec) {
+    int i;
+
+    if (usec < 0) {
+	usec = 0;
+    }
+
+    for (i = 0; i < HISTOGRAM_N_BUCKETS - 1; i ++) {
+	if (usec < (HISTOGRAM_BUCKET_MIN << i)) {
+	    break;
+	}
+    }
+
+    histogram->buckets[i] ++;
+    histogram->count ++;
+    histogram->sum += usec;
+
+    if (usec > histogram->max) {
+	histogram->max = usec;
+    }
+}
+
+GVariant* histogram_to_variant(const Histogram *histogram) {
+    return g_variant_new("(ttt@at)",
+	    histogram->count,
+	    histogram->sum,
+	    histogram->max,
+	    g_variant_new_fixed_array(G_VARIANT_TYPE_UINT64, histogram->buckets, HISTOGRAM_N_BUCKETS, sizeof(guint64)));
+}
+
+/*
+ * Returns the upper bound of the bucket containing the given quantile, in
+ * microseconds.
+ */
+static guint64 histogram_quantile(guint64 count, guint64 max, const guint64 *buckets, gsize n_buckets, gdouble q) {
+    guint64 sum, target;
+
+    target = (guint64) (q * count + 0.5);
+    sum = 0;
+
+    for (int i = 0; i < n_buckets - 1; i ++) {
+	sum += buckets[i];
+
+	if (sum >= target) {
+	    return MIN((guint64) HISTOGRAM_BUCKET_MIN << i, max);
+	}
+    }
+
+    return max;
+}
+
+gchar* histogram_format(GVariant *histogram_var) {
+    guint64 count, sum, max;
+    GVariant *buckets_var;
+    const guint64 *buckets;
+    gsize n_buckets;
+    gchar *str;
+
+    g_variant_get(histogram_var, "(ttt@at)", &count, &sum, &max, &buckets_var);
+    buckets = g_variant_get_fixed_array(buckets_var, &n_buckets, sizeof(guint64));
+
+    if (count == 0) {
+	str = g_strdup("n=0");
+    }
+    else {
+	str = g_strdup_printf("n=%" G_GUINT64_FORMAT " mean=%.2fms p50<=%.2fms p90<=%.2fms p99<=%.2fms max=%.2fms",
+		count,
+		(gdouble) sum / count / 1000,
+		histogram_quantile(count, max, buckets, n_buckets, 0.50) / 1000.0,
+		histogram_quantile(count, max, buckets, n_buckets, 0.90) / 1000.0,
+		histogram_quantile(count, max, buckets, n_buckets, 0.99) / 1000.0,
+		max / 1000.0);
+    }
+
+    g_variant_unref(buckets_var);
+    return str;
+}
+
+void stats_connection_watch(GDBusConnection *connection, const gchar *bus) {
+    StatsConnection *sc;
+
+    g_mutex_lock(&stats_mutex);
+
+    for (GSList *i = stats_connections; i != NULL; i = i->next) {
+	if (((StatsConnection *) i->data)->connection == connection) {
+	    g_mutex_unlock(&stats_mutex);
+	    return;
+	}
+    }
+
+    sc = g_malloc(sizeof(StatsConnection));
+    sc->connection = connection;
+    sc->bus = bus;
+    sc->counters = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    sc->calls_sent = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    sc->calls_received = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    sc->expiry_time = g_get_monotonic_time();
+
+    stats_connections = g_slist_prepend(stats_connections, sc);
+    g_mutex_unlock(&stats_mutex);
+
+    g_dbus_connection_add_filter(connection, (GDBusMessageFilterFunction) stats_message_filter, sc, NULL);
+}
+
+/*
+ * Returns an interned "interface.member" key. The org.freedesktop.DBus.Properties
+ * methods and signals are further broken down by the interface (and property) that
+ * they refer to, since otherwise all PropertiesChanged traffic from iwd would be
+ * lumped together.
+ */
+static const gchar* stats_message_key(GDBusMessage *message) {
+    const gchar *interface, *member;
+    GVariant *body;
+    const gchar *key;
+
+    interface = g_dbus_message_get_interface(message);
+    member = g_dbus_message_get_member(message);
+    body = g_dbus_message_get_body(message);
+
+    if (interface == NULL) {
+	interface = "(none)";
+    }
+
+    if (member == NULL) {
+	member = "(none)";
+    }
+
+    if (body && strcmp(interface, "org.freedesktop.DBus.Properties") == 0 && g_variant_n_children(body) > 0) {
+	GVariant *target_var, *property_var;
+	gchar *key_tmp;
+
+	target_var = g_variant_get_child_value(body, 0);
+	property_var = g_variant_n_children(body) > 1 ? g_variant_get_child_value(body, 1) : NULL;
+
+	if (g_variant_is_of_type(target_var, G_VARIANT_TYPE_STRING)) {
+	    if (property_var && g_variant_is_of_type(property_var, G_VARIANT_TYPE_STRING)) {
+		key_tmp = g_strdup_printf("%s.%s[%s.%s]", interface, member,
+			g_variant_get_string(target_var, NULL),
+			g_variant_get_string(property_var, NULL));
+	    }
+	    else {
+		key_tmp = g_strdup_printf("%s.%s[%s]", interface, member, g_variant_get_string(target_var, NULL));
+	    }
+	}
+	else {
+	    key_tmp = g_strdup_printf("%s.%s", interface, member);
+	}
+
+	key = g_intern_string(key_tmp);
+	g_free(key_tmp);
+
+	g_variant_unref(target_var);
+	if (property_var) {
+	    g_variant_unref(property_var);
+	}
+    }
+    else {
+	gchar *key_tmp;
+
+	key_tmp = g_strdup_printf("%s.%s", interface, member);
+	key = g_intern_string(key_tmp);
+	g_free(key_tmp);
+    }
+
+    return key;
+}
+
+static void stats_calls_expire(GHashTable *calls, gint64 cutoff) {
+    GHashTableIter iter;
+    DBusCall *call;
+
+    g_hash_table_iter_init(&iter, calls);
+
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &call)) {
+	if (call->time < cutoff) {
+	    g_hash_table_iter_remove(&iter);
+	}
+    }
+}
+
+/*
+ * Forgets calls which will never be answered, e.g. because the peer has vanished.
+ * This runs at most once every STATS_CALL_EXPIRY seconds.
+ */
+static void stats_connection_expire(StatsConnection *sc, gint64 now) {
+    if (now - sc->expiry_time < STATS_CALL_EXPIRY * G_USEC_PER_SEC) {
+	return;
+    }
+
+    stats_calls_expire(sc->calls_sent, now - STATS_CALL_EXPIRY * G_USEC_PER_SEC);
+    stats_calls_expire(sc->calls_received, now - STATS_CALL_EXPIRY * G_USEC_PER_SEC);
+    sc->expiry_time = now;
+}
+
+/*
+ * A received call is identified by its sender and serial, since serials are only
+ * unique per sender.
+ */
+static gchar* stats_received_call_id(const gchar *peer, guint32 serial) {
+    return g_strdup_printf("%s %u", peer != NULL ? peer : "", serial);
+}
+
+GDBusMessage* stats_message_filter(GDBusConnection *connection, GDBusMessage *message, gboolean incoming, StatsConnection *sc) {
+    GDBusMessageType type;
+    const gchar *key;
+    gpointer serial;
+    gint64 latency, now;
+    gsize size;
+
+    {
+	GVariant *body;
+
+	body = g_dbus_message_get_body(message);
+	size = body ? g_variant_get_size(body) : 0;
+    }
+
+    type = g_dbus_message_get_message_type(message);
+    latency = -1;
+    now = g_get_monotonic_time();
+
+    if (type == G_DBUS_MESSAGE_TYPE_METHOD_RETURN || type == G_DBUS_MESSAGE_TYPE_ERROR) {
+	key = NULL;
+	serial = GUINT_TO_POINTER(g_dbus_message_get_reply_serial(message));
+    }
+    else {
+	key = stats_message_key(message);
+	serial = GUINT_TO_POINTER(g_dbus_message_get_serial(message));
+    }
+
+    g_mutex_lock(&stats_mutex);
+
+    switch (type) {
+	case G_DBUS_MESSAGE_TYPE_METHOD_CALL:
+	    if (g_dbus_message_get_flags(message) & G_DBUS_MESSAGE_FLAGS_NO_REPLY_EXPECTED) {
+		break;
+	    }
+
+	    {
+		DBusCall *call;
+
+		call = g_malloc(sizeof(DBusCall));
+		call->key = key;
+		call->time = now;
+
+		if (incoming) {
+		    g_hash_table_insert(sc->calls_received, stats_received_call_id(g_dbus_message_get_sender(message), GPOINTER_TO_UINT(serial)), call);
+		}
+		else {
+		    g_hash_table_insert(sc->calls_sent, serial, call);
+		}
+	    }
+
+	    break;
+	case G_DBUS_MESSAGE_TYPE_METHOD_RETURN:
+	case G_DBUS_MESSAGE_TYPE_ERROR:
+	    if (incoming) {
+		DBusCall *call;
+
+		call = g_hash_table_lookup(sc->calls_sent, serial);
+
+		if (call) {
+		    key = call->key;
+		    latency = now - call->time;
+		    g_hash_table_remove(sc->calls_sent, serial);
+		}
+	    }
+	    else {
+		DBusCall *call;
+		gchar *id;
+
+		id = stats_received_call_id(g_dbus_message_get_destination(message), GPOINTER_TO_UINT(serial));
+		call = g_hash_table_lookup(sc->calls_received, id);
+
+		if (call) {
+		    key = call->key;
+		    g_hash_table_remove(sc->calls_received, id);
+		}
+
+		g_free(id);
+	    }
+
+	    if (key == NULL) {
+		key = g_intern_static_string("(unmatched reply)");
+	    }
+
+	    break;
+	default:
+	    break;
+    }
+
+    stats_connection_expire(sc, now);
+
+    {
+	DBusCounter *counter;
+
+	counter = g_hash_table_lookup(sc->counters, key);
+
+	if (counter == NULL) {
+	    counter = g_malloc0(sizeof(DBusCounter));
+	    g_hash_table_insert(sc->counters, (gpointer) key, counter);
+	}
+
+	if (incoming) {
+	    counter->messages_received ++;
+	    counter->bytes_received += size;
+	}
+	else {
+	    counter->messages_sent ++;
+	    counter->bytes_sent += size;
+	}
+
+	if (latency >= 0) {
+	    histogram_add(&counter->latency, latency);
+	}
+    }
+
+    g_mutex_unlock(&stats_mutex);
+    return message;
+}
+
+/*
+ * Adds one "dbus.<bus>.<interface>.<member>" entry per counter to an a{sv} builder,
+ * plus a "dbus-latency.<bus>.<interface>.<member>" histogram for each method which
+ * iwgtk has called.
+ */
+void stats_dbus_collect(GVariantBuilder *builder) {
+    g_mutex_lock(&stats_mutex);
+
+    for (GSList *i = stats_connections; i != NULL; i = i->next) {
+	StatsConnection *sc;
+	GHashTableIter iter;
+	const gchar *key;
+	DBusCounter *counter;
+
+	sc = (StatsConnection *) i->data;
+	g_hash_table_iter_init(&iter, sc->counters);
+
+	while (g_hash_table_iter_next(&iter, (gpointer *) &key, (gpointer *) &counter)) {
+	    gchar *name;
+
+	    name = g_strdup_printf("dbus.%s.%s", sc->bus, key);
+	    g_variant_builder_add(builder, "{sv}", name, g_variant_new("(tttt)",
+			counter->messages_received,
+			counter->bytes_received,
+			counter->messages_sent,
+			counter->bytes_sent));
+	    g_free(name);
+
+	    if (counter->latency.count > 0) {
+		name = g_strdup_printf("dbus-latency.%s.%s", sc->bus, key);
+		g_variant_builder_add(builder, "{sv}", name, histogram_to_variant(&counter->latency));
+		g_free(name);
+	    }
+	}
+    }
+
+    g_mutex_unlock(&stats_mutex);
+}
+
+guint stats_dbus_pending_calls() {
+    guint n;
+
+    n = 0;
+    g_mutex_lock(&stats_mutex);
+
+    for (GSList *i = stats_connections; i != NULL; i = i->next) {
+	StatsConnection *sc;
+
+	sc = (StatsConnection *) i->data;
+	stats_connection_expire(sc, g_get_monotonic_time());
+	n += g_hash_table_size(sc->calls_sent);
+    }
+
+    g_mutex_unlock(&stats_mutex);
+    return n;
+}
+
+static gint stats_entry_compare(GVariant **entry0, GVariant **entry1) {
+    const gchar *key0, *key1;
+
+    g_variant_get(*entry0, "{&sv}", &key0, NULL);
+    g_variant_get(*entry1, "{&sv}", &key1, NULL);
+    return strcmp(key0, key1);
+}
+
+/*
+ * Renders an a{sv} statistics dictionary as text, one sorted entry per line.
+ */
+gchar* stats_format(GVariant *stats) {
+    GString *str;
+    GPtrArray *entries;
+    GVariantIter iter;
+    GVariant *entry;
+
+    entries = g_ptr_array_new_with_free_func((GDestroyNotify) g_variant_unref);
+    g_variant_iter_init(&iter, stats);
+
+    while ((entry = g_variant_iter_next_value(&iter))) {
+	g_ptr_array_add(entries, entry);
+    }
+
+    g_ptr_array_sort(entries, (GCompareFunc) stats_entry_compare);
+    str = g_string_new(NULL);
+
+    for (int i = 0; i < entries->len; i ++) {
+	const gchar *key;
+	GVariant *value;
+	gchar *value_str;
+
+	g_variant_get(g_ptr_array_index(entries, i), "{&sv}", &key, &value);
+
+	if (g_variant_is_of_type(value, G_VARIANT_TYPE("(tttt)"))) {
+	    guint64 msg_in, bytes_in, msg_out, bytes_out;
+
+	    g_variant_get(value, "(tttt)", &msg_in, &bytes_in, &msg_out, &bytes_out);
+	    value_str = g_strdup_printf("in: %" G_GUINT64_FORMAT " msg/%" G_GUINT64_FORMAT " B, out: %" G_GUINT64_FORMAT " msg/%" G_GUINT64_FORMAT " B",
+		    msg_in, bytes_in, msg_out, bytes_out);
+	}
+	else if (g_variant_is_of_type(value, G_VARIANT_TYPE("(tttat)"))) {
+	    value_str = histogram_format(value);
+	}
+	else {
+	    value_str = g_variant_print(value, FALSE);
+	}
+
+	g_string_append_printf(str, "%s: %s\n", key, value_str);
+
+	g_free(value_str);
+	g_variant_unref(value);
+    }
+
+    g_ptr_array_free(entries, TRUE);
+    return g_string_free(str, FALSE);
+}
@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_STATS_H
+#define _IWGTK_STATS_H
+
+#define HISTOGRAM_N_BUCKETS 12
+#define HISTOGRAM_BUCKET_MIN 250
+
+/*
+ * Calls which haven't been answered after this many seconds are forgotten. This
+ * exceeds the longest timeout that iwgtk uses for its own calls.
+ */
+#define STATS_CALL_EXPIRY 180
+
+typedef struct Histogram_s Histogram;
+typedef struct DBusCounter_s DBusCounter;
+typedef struct DBusCall_s DBusCall;
+typedef struct StatsConnection_s StatsConnection;
+
+/*
+ * Bucket i counts samples below HISTOGRAM_BUCKET_MIN << i microseconds. The last
+ * bucket counts everything else.
+ */
+struct Histogram_s {
+    guint64 count;
+    guint64 sum;
+    guint64 max;
+    guint64 buckets[HISTOGRAM_N_BUCKETS];
+};
+
+struct DBusCounter_s {
+    guint64 messages_received;
+    guint64 bytes_received;
+    guint64 messages_sent;
+    guint64 bytes_sent;
+    Histogram latency;
+};
+
+struct DBusCall_s {
+    const gchar *key;
+    gint64 time;
+};
+
+struct StatsConnection_s {
+    GDBusConnection *connection;
+    const gchar *bus;
+
+    // Interned "interface.member" string -> DBusCounter
+    GHashTable *counters;
+
+    // Serial -> DBusCall, for method calls which we have sent
+    GHashTable *calls_sent;
+
+    // "<sender> <serial>" -> DBusCall, for method calls which we have received
+    GHashTable *calls_received;
+
+    gint64 expiry_time;
+};
+
+void histogram_add(Histogram *histogram, gint64 usec);
+GVariant* histogram_to_variant(const Histogram *histogram);
+gchar* histogram_format(GVariant *histogram_var);
+
+void stats_connection_watch(GDBusConnection *connection, const gchar *bus);
+GDBusMessage* stats_message_filter(GDBusConnection *connection, GDBusMessage *message, gboolean incoming, StatsConnection *sc);
+void stats_dbus_collect(GVariantBuilder *builder);
+guint stats_dbus_pending_calls();
+
+gchar* stats_format(GVariant *stats);
+
+#endif
@@ -0,0 +1,596 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+static gboolean survey_frame_header_read(GSeekable *stream, guint64 offset, guint32 *length, guchar *kind, gint64 *timestamp, GError **err) {
+    guchar header[SURVEY_FRAME_HEADER_LEN + sizeof(gint64)];
+    gsize n;
+
+    if (!g_seekable_seek(stream, offset, G_SEEK_SET, NULL, err)) {
+	return FALSE;
+    }
+
+    if (!g_input_stream_read_all(g_io_stream_get_input_stream(G_IO_STREAM(stream)), header, sizeof(header), &n, NULL, err)) {
+	return FALSE;
+    }
+
+    if (n < SURVEY_FRAME_HEADER_LEN) {
+	*length = G_MAXUINT32;
+	return TRUE;
+    }
+
+    memcpy(length, header, sizeof(guint32));
+    *length = GUINT32_FROM_LE(*length);
+    *kind = header[4];
+
+    // Every record payload starts with its timestamp
+    if (n == sizeof(header) && *length >= sizeof(gint64)) {
+	memcpy(timestamp, header + SURVEY_FRAME_HEADER_LEN, sizeof(gint64));
+	*timestamp = GINT64_FROM_LE(*timestamp);
+    }
+    else {
+	*timestamp = 0;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Find the end of the last complete frame, so that a survey which was cut short
+ * (e.g. by a crash or a flat battery) can be resumed. The records which follow the
+ * last index frame are put back into the pending index.
+ */
+static gboolean survey_file_recover(Survey *survey, GError **err) {
+    GSeekable *stream;
+    guint64 size;
+
+    stream = G_SEEKABLE(survey->stream);
+
+    if (!g_seekable_seek(stream, 0, G_SEEK_END, NULL, err)) {
+	return FALSE;
+    }
+
+    size = g_seekable_tell(stream);
+
+    if (size == 0) {
+	if (!g_output_stream_write_all(g_io_stream_get_output_stream(G_IO_STREAM(survey->stream)), SURVEY_MAGIC, SURVEY_MAGIC_LEN, NULL, NULL, err)) {
+	    return FALSE;
+	}
+
+	survey->offset = SURVEY_MAGIC_LEN;
+	return TRUE;
+    }
+
+    {
+	gchar magic[SURVEY_MAGIC_LEN];
+	gsize n;
+
+	if (!g_seekable_seek(stream, 0, G_SEEK_SET, NULL, err) ||
+	    !g_input_stream_read_all(g_io_stream_get_input_stream(G_IO_STREAM(survey->stream)), magic, SURVEY_MAGIC_LEN, &n, NULL, err)) {
+	    return FALSE;
+	}
+
+	if (n != SURVEY_MAGIC_LEN || memcmp(magic, SURVEY_MAGIC, SURVEY_MAGIC_LEN) != 0) {
+	    g_set_error(err, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Not an iwgtk survey file");
+	    return FALSE;
+	}
+    }
+
+    survey->offset = SURVEY_MAGIC_LEN;
+
+    while (survey->offset + SURVEY_FRAME_HEADER_LEN <= size) {
+	guint32 length;
+	guchar kind;
+	gint64 timestamp;
+
+	if (!survey_frame_header_read(stream, survey->offset, &length, &kind, &timestamp, err)) {
+	    return FALSE;
+	}
+
+	if (survey->offset + SURVEY_FRAME_HEADER_LEN + length > size) {
+	    break;
+	}
+
+	if (kind == SURVEY_RECORD_INDEX) {
+	    survey->index_offset = survey->offset;
+	    g_array_set_size(survey->index, 0);
+	}
+	else {
+	    SurveyIndexEntry entry = {timestamp, survey->offset};
+	    g_array_append_val(survey->index, entry);
+	}
+
+	survey->offset += SURVEY_FRAME_HEADER_LEN + length;
+    }
+
+    if (survey->offset < size) {
+	g_printerr("Discarding incomplete survey record (%" G_GUINT64_FORMAT " bytes)\n", size - survey->offset);
+
+	if (!g_seekable_truncate(stream, survey->offset, NULL, err)) {
+	    return FALSE;
+	}
+    }
+
+    return g_seekable_seek(stream, survey->offset, G_SEEK_SET, NULL, err);
+}
+
+static void survey_free(Survey *survey) {
+    if (survey->timeout_id != 0) {
+	g_source_remove(survey->timeout_id);
+    }
+
+    if (survey->stream) {
+	g_io_stream_close(G_IO_STREAM(survey->stream), NULL, NULL);
+	g_object_unref(survey->stream);
+    }
+
+    g_array_unref(survey->index);
+    g_object_unref(survey->file);
+    g_free(survey);
+}
+
+static gboolean survey_frame_write(Survey *survey, SurveyRecordKind kind, GVariant *payload) {
+    guchar *frame;
+    gsize size;
+    gboolean success;
+
+    payload = g_variant_ref_sink(payload);
+
+    if (G_BYTE_ORDER == G_BIG_ENDIAN) {
+	GVariant *swapped;
+
+	swapped = g_variant_byteswap(payload);
+	g_variant_unref(payload);
+	payload = swapped;
+    }
+
+    size = g_variant_get_size(payload);
+    frame = g_malloc(SURVEY_FRAME_HEADER_LEN + size);
+
+    {
+	guint32 length;
+
+	length = GUINT32_TO_LE(size);
+	memcpy(frame, &length, sizeof(guint32));
+	frame[4] = kind;
+    }
+
+    g_variant_store(payload, frame + SURVEY_FRAME_HEADER_LEN);
+    g_variant_unref(payload);
+
+    {
+	GError *err;
+
+	err = NULL;
+	success = g_output_stream_write_all(g_io_stream_get_output_stream(G_IO_STREAM(survey->stream)), frame, SURVEY_FRAME_HEADER_LEN + size, NULL, NULL, &err);
+
+	if (success) {
+	    survey->offset += SURVEY_FRAME_HEADER_LEN + size;
+	}
+	else {
+	    g_printerr("Failed to write to survey file: %s\n", err->message);
+	    g_error_free(err);
+	}
+    }
+
+    g_free(frame);
+    return success;
+}
+
+static gboolean survey_index_write(Survey *survey) {
+    GVariantBuilder builder;
+    guint64 offset;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a(xt)"));
+
+    for (guint i = 0; i < survey->index->len; i ++) {
+	SurveyIndexEntry *entry;
+
+	entry = &g_array_index(survey->index, SurveyIndexEntry, i);
+	g_variant_builder_add(&builder, "(xt)", entry->timestamp, entry->offset);
+    }
+
+    offset = survey->offset;
+
+    if (!survey_frame_write(survey, SURVEY_RECORD_INDEX, g_variant_new("(ta(xt))", survey->index_offset, &builder))) {
+	return FALSE;
+    }
+
+    survey->index_offset = offset;
+    g_array_set_size(survey->index, 0);
+    return TRUE;
+}
+
+gboolean survey_start(GFile *file) {
+    Survey *survey;
+    GError *err;
+
+    if (global.survey) {
+	if (g_file_equal(global.survey->file, file)) {
+	    return TRUE;
+	}
+
+	survey_stop();
+    }
+
+    survey = g_malloc(sizeof(Survey));
+    survey->file = g_object_ref(file);
+    survey->offset = 0;
+    survey->index_offset = 0;
+    survey->index = g_array_sized_new(FALSE, FALSE, sizeof(SurveyIndexEntry), SURVEY_INDEX_INTERVAL);
+    survey->timeout_id = 0;
+
+    err = NULL;
+    survey->stream = g_file_open_readwrite(file, NULL, &err);
+
+    if (!survey->stream && g_error_matches(err, G_IO_ERROR, G_IO_ERROR_NOT_FOUND)) {
+	g_clear_error(&err);
+	survey->stream = g_file_create_readwrite(file, G_FILE_CREATE_NONE, NULL, &err);
+    }
+
+    if (!survey->stream || !survey_file_recover(survey, &err)) {
+	gchar *path;
+
+	path = g_file_get_parse_name(file);
+	g_printerr("Failed to open survey file '%s': %s\n", path, err->message);
+	g_free(path);
+	g_error_free(err);
+
+	survey_free(survey);
+	return FALSE;
+    }
+
+    global.survey = survey;
+
+    if (~global.state & CONFIG_PENDING) {
+	survey_scan_schedule();
+    }
+
+    return TRUE;
+}
+
+void survey_stop() {
+    if (global.survey) {
+	if (global.survey->index->len > 0) {
+	    survey_index_write(global.survey);
+	}
+
+	survey_free(global.survey);
+	global.survey = NULL;
+    }
+}
+
+void survey_scan_schedule() {
+    if (global.survey->timeout_id != 0) {
+	g_source_remove(global.survey->timeout_id);
+    }
+
+    global.survey->timeout_id = g_timeout_add_seconds(global.survey_interval > 0 ? global.survey_interval : SURVEY_INTERVAL_DEFAULT, (GSourceFunc) survey_scan_timeout, NULL);
+}
+
+/*
+ * Unlike the background scans, survey scans run at a fixed cadence, whether or not
+ * the window is visible.
+ */
+gboolean survey_scan_timeout() {
+    if (global.window) {
+	for (ObjectList *list = global.window->objects[OBJECT_STATION]; list != NULL; list = list->next) {
+	    Station *station;
+
+	    station = list->data;
+
+	    if (station->state != STATION_SCANNING) {
+		g_dbus_proxy_call(
+		    station->proxy,
+		    "Scan",
+		    NULL,
+		    G_DBUS_CALL_FLAGS_NONE,
+		    -1,
+		    NULL,
+		    (GAsyncReadyCallback) survey_scan_callback,
+		    NULL);
+	    }
+	}
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+void survey_scan_callback(GDBusProxy *proxy, GAsyncResult *res, gpointer user_data) {
+    GVariant *ret;
+    GError *err;
+
+    err = NULL;
+    ret = g_dbus_proxy_call_finish(proxy, res, &err);
+
+    if (ret) {
+	g_variant_unref(ret);
+    }
+    else {
+	// A busy station (e.g. one which is connecting) is picked up on the next round
+	if (err->domain != global.iwd_error_domain || err->code != IWD_ERROR_BUSY) {
+	    g_printerr("Survey scan request failed: %s\n", err->message);
+	}
+
+	g_error_free(err);
+    }
+}
+
+static gchar* survey_device_name(GDBusProxy *station_proxy) {
+    GDBusProxy *device_proxy;
+    gchar *name;
+
+    name = NULL;
+    device_proxy = G_DBUS_PROXY(g_dbus_object_manager_get_interface(global.manager, g_dbus_proxy_get_object_path(station_proxy), IWD_IFACE_DEVICE));
+
+    if (device_proxy) {
+	GVariant *name_var;
+
+	name_var = g_dbus_proxy_get_cached_property(device_proxy, "Name");
+
+	if (name_var) {
+	    name = g_variant_dup_string(name_var, NULL);
+	    g_variant_unref(name_var);
+	}
+
+	g_object_unref(device_proxy);
+    }
+
+    if (name == NULL) {
+	name = g_strdup(g_dbus_proxy_get_object_path(station_proxy));
+    }
+
+    return name;
+}
+
+static void survey_record(GDBusProxy *station_proxy, SurveyRecordKind kind, GVariantBuilder *entries) {
+    Survey *survey;
+    SurveyIndexEntry entry;
+    gchar *device_name;
+    gboolean success;
+
+    survey = global.survey;
+    entry.timestamp = g_get_real_time();
+    entry.offset = survey->offset;
+
+    device_name = survey_device_name(station_proxy);
+    success = survey_frame_write(survey, kind, g_variant_new("(xsa(ssn))", entry.timestamp, device_name, entries));
+    g_free(device_name);
+
+    if (success) {
+	g_array_append_val(survey->index, entry);
+
+	if (survey->index->len >= SURVEY_INDEX_INTERVAL) {
+	    success = survey_index_write(survey);
+	}
+    }
+
+    if (!success) {
+	g_printerr("Survey stopped\n");
+	survey_free(survey);
+	global.survey = NULL;
+    }
+}
+
+void survey_record_networks(GDBusProxy *station_proxy, GVariant *ordered_networks) {
+    GVariantBuilder builder;
+    GVariantIter *iter;
+    const gchar *network_path;
+    gint16 signal_strength;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a(ssn)"));
+    g_variant_get(ordered_networks, "(a(on))", &iter);
+
+    while (g_variant_iter_next(iter, "(&on)", &network_path, &signal_strength)) {
+	GDBusProxy *network_proxy;
+
+	network_proxy = G_DBUS_PROXY(g_dbus_object_manager_get_interface(global.manager, network_path, IWD_IFACE_NETWORK));
+
+	if (network_proxy) {
+	    GVariant *name_var, *type_var;
+
+	    name_var = g_dbus_proxy_get_cached_property(network_proxy, "Name");
+	    type_var = g_dbus_proxy_get_cached_property(network_proxy, "Type");
+
+	    g_variant_builder_add(&builder, "(ssn)",
+		name_var ? g_variant_get_string(name_var, NULL) : "",
+		type_var ? g_variant_get_string(type_var, NULL) : "",
+		signal_strength);
+
+	    if (name_var) {
+		g_variant_unref(name_var);
+	    }
+
+	    if (type_var) {
+		g_variant_unref(type_var);
+	    }
+
+	    g_object_unref(network_proxy);
+	}
+    }
+
+    g_variant_iter_free(iter);
+    survey_record(station_proxy, SURVEY_RECORD_NETWORKS, &builder);
+}
+
+void survey_record_hidden(GDBusProxy *station_proxy, GVariant *hidden_networks) {
+    GVariantBuilder builder;
+    GVariantIter *iter;
+    const gchar *address;
+    gint16 signal_strength;
+    const gchar *type;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a(ssn)"));
+    g_variant_get(hidden_networks, "(a(sns))", &iter);
+
+    while (g_variant_iter_next(iter, "(&sn&s)", &address, &signal_strength, &type)) {
+	g_variant_builder_add(&builder, "(ssn)", address, type, signal_strength);
+    }
+
+    g_variant_iter_free(iter);
+    survey_record(station_proxy, SURVEY_RECORD_HIDDEN, &builder);
+}
+
+/*
+ * Write the network lists in a survey file to stdout, as CSV or as a JSON array.
+ * Index frames are skipped. The file is parsed without any help from the running
+ * instance, so this can be used while a survey is still in progress.
+ */
+gint survey_export(const gchar *path, const gchar *format) {
+    GMappedFile *mapped;
+    GString *line;
+    const gchar *contents;
+    gsize size, offset;
+    gboolean json, first;
+
+    if (format == NULL || strcmp(format, "csv") == 0) {
+	json = FALSE;
+    }
+    else if (strcmp(format, "json") == 0) {
+	json = TRUE;
+    }
+    else {
+	g_printerr("Unknown survey export format: %s\n", format);
+	return 1;
+    }
+
+    {
+	GError *err;
+
+	err = NULL;
+	mapped = g_mapped_file_new(path, FALSE, &err);
+
+	if (mapped == NULL) {
+	    g_printerr("Failed to open survey file: %s\n", err->message);
+	    g_error_free(err);
+	    return 1;
+	}
+    }
+
+    contents = g_mapped_file_get_contents(mapped);
+    size = g_mapped_file_get_length(mapped);
+
+    if (size < SURVEY_MAGIC_LEN || memcmp(contents, SURVEY_MAGIC, SURVEY_MAGIC_LEN) != 0) {
+	g_printerr("%s: Not an iwgtk survey file\n", path);
+	g_mapped_file_unref(mapped);
+	return 1;
+    }
+
+    puts(json ? "[" : "time,device,ssid,address,type,signal");
+    line = g_string_new(NULL);
+    offset = SURVEY_MAGIC_LEN;
+    first = TRUE;
+
+    while (offset + SURVEY_FRAME_HEADER_LEN <= size) {
+	guint32 length;
+	guchar kind;
+
+	memcpy(&length, contents + offset, sizeof(guint32));
+	length = GUINT32_FROM_LE(length);
+	kind = contents[offset + 4];
+
+	if (length > size - offset - SURVEY_FRAME_HEADER_LEN) {
+	    break;
+	}
+
+	if (kind == SURVEY_RECORD_NETWORKS || kind == SURVEY_RECORD_HIDDEN) {
+	    GVariant *record;
+	    GVariantIter *iter;
+	    gint64 timestamp;
+	    const gchar *device, *name, *type;
+	    gint16 signal_strength;
+	    gchar *time_str;
+
+	    // Copy the payload, since the frames aren't aligned
+	    {
+		GBytes *bytes;
+
+		bytes = g_bytes_new(contents + offset + SURVEY_FRAME_HEADER_LEN, length);
+		record = g_variant_ref_sink(g_variant_new_from_bytes(G_VARIANT_TYPE("(xsa(ssn))"), bytes, FALSE));
+		g_bytes_unref(bytes);
+	    }
+
+	    if (G_BYTE_ORDER == G_BIG_ENDIAN) {
+		GVariant *swapped;
+
+		swapped = g_variant_byteswap(record);
+		g_variant_unref(record);
+		record = swapped;
+	    }
+
+	    g_variant_get(record, "(x&sa(ssn))", &timestamp, &device, &iter);
+	    time_str = timestamp_format(timestamp);
+
+	    while (g_variant_iter_next(iter, "(&s&sn)", &name, &type, &signal_strength)) {
+		gchar signal[G_ASCII_DTOSTR_BUF_SIZE];
+
+		// Independent of LC_NUMERIC, unlike printf()
+		g_ascii_formatd(signal, sizeof(signal), "%.2f", signal_strength / 100.0);
+
+		g_string_truncate(line, 0);
+
+		if (json) {
+		    g_string_append(line, first ? "  {\"time\": " : ",\n  {\"time\": ");
+		    json_string_append(line, time_str);
+		    g_string_append(line, ", \"device\": ");
+		    json_string_append(line, device);
+		    g_string_append(line, kind == SURVEY_RECORD_NETWORKS ? ", \"ssid\": " : ", \"address\": ");
+		    json_string_append(line, name);
+		    g_string_append(line, ", \"type\": ");
+		    json_string_append(line, type);
+		    g_string_append_printf(line, ", \"signal\": %s}", signal);
+		}
+		else {
+		    g_string_append_printf(line, "%s,", time_str);
+		    csv_field_append(line, device);
+		    g_string_append_c(line, ',');
+		    csv_field_append(line, kind == SURVEY_RECORD_NETWORKS ? name : "");
+		    g_string_append_c(line, ',');
+		    csv_field_append(line, kind == SURVEY_RECORD_HIDDEN ? name : "");
+		    g_string_append_c(line, ',');
+		    csv_field_append(line, type);
+		    g_string_append_printf(line, ",%s\n", signal);
+		}
+
+		fputs(line->str, stdout);
+		first = FALSE;
+	    }
+
+	    g_free(time_str);
+	    g_variant_iter_free(iter);
+	    g_variant_unref(record);
+	}
+
+	offset += SURVEY_FRAME_HEADER_LEN + length;
+    }
+
+    g_string_free(line, TRUE);
+
+    if (json) {
+	puts(first ? "]" : "\n]");
+    }
+
+    if (offset < size) {
+	g_printerr("%s: Ignoring incomplete record at end of file\n", path);
+    }
+
+    g_mapped_file_unref(mapped);
+    return 0;
+}
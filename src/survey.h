@@ -0,0 +1,74 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_SURVEY_H
+#define _IWGTK_SURVEY_H
+
+/*
+ * A survey file starts with SURVEY_MAGIC, which is followed by a sequence of
+ * frames. Each frame consists of a 32-bit little-endian payload length, a kind
+ * byte, and a little-endian serialized GVariant payload:
+ *
+ * SURVEY_RECORD_NETWORKS, SURVEY_RECORD_HIDDEN: (xsa(ssn))
+ *     Timestamp (microseconds since the epoch), device name, and one
+ *     (SSID or BSSID, type, signal strength in 100 * dBm) entry per result.
+ *
+ * SURVEY_RECORD_INDEX: (ta(xt))
+ *     File offset of the previous index frame (0 if there is none), and the
+ *     (timestamp, file offset) of every record written since that frame.
+ */
+#define SURVEY_MAGIC "iwgtksv\1"
+#define SURVEY_MAGIC_LEN 8
+#define SURVEY_FRAME_HEADER_LEN 5
+#define SURVEY_INDEX_INTERVAL 64
+#define SURVEY_INTERVAL_DEFAULT 10
+
+typedef struct Survey_s Survey;
+typedef struct SurveyIndexEntry_s SurveyIndexEntry;
+
+typedef enum {
+    SURVEY_RECORD_NETWORKS = 1,
+    SURVEY_RECORD_HIDDEN,
+    SURVEY_RECORD_INDEX
+} SurveyRecordKind;
+
+struct SurveyIndexEntry_s {
+    gint64 timestamp;
+    guint64 offset;
+};
+
+struct Survey_s {
+    GFile *file;
+    GFileIOStream *stream;
+    guint64 offset;
+    guint64 index_offset;
+    GArray *index;
+    guint timeout_id;
+};
+
+gboolean survey_start(GFile *file);
+void survey_stop();
+void survey_scan_schedule();
+gboolean survey_scan_timeout();
+void survey_scan_callback(GDBusProxy *proxy, GAsyncResult *res, gpointer user_data);
+void survey_record_networks(GDBusProxy *station_proxy, GVariant *ordered_networks);
+void survey_record_hidden(GDBusProxy *station_proxy, GVariant *hidden_networks);
+gint survey_export(const gchar *path, const gchar *format);
+
+#endif
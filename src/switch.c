@@ -25,21 +25,29 @@
  * (returning TRUE would cause "state" not to be updated).
  */
 gboolean switch_handler(GtkSwitch *widget, gboolean state, SwitchData *switch_data) {
-    set_remote_property(switch_data->proxy, switch_data->property, g_variant_new_boolean(state), (SetFunction) switch_set, switch_data);
+    pending_property_set(switch_data->proxy, switch_data->property, g_variant_new_boolean(state), (PendingRefresh) switch_set, switch_data);
     return FALSE;
 }
 
+/*
+ * Shows the value which the property has, or which the user has asked for. The
+ * handler is blocked, so that this doesn't count as a change made by the user.
+ */
 void switch_set(SwitchData *switch_data) {
     GVariant *state_var;
     gboolean state;
 
-    state_var = g_dbus_proxy_get_cached_property(switch_data->proxy, switch_data->property);
+    state_var = pending_property_get(switch_data->proxy, switch_data->property);
     state = g_variant_get_boolean(state_var);
-    gtk_switch_set_active(GTK_SWITCH(switch_data->widget), state);
     g_variant_unref(state_var);
+
+    g_signal_handlers_block_by_func(switch_data->widget, switch_handler, switch_data);
+    gtk_switch_set_active(GTK_SWITCH(switch_data->widget), state);
+    g_signal_handlers_unblock_by_func(switch_data->widget, switch_handler, switch_data);
 }
 
 void switch_rm(GtkWidget *widget, SwitchData *switch_data) {
+    pending_refresh_cancel(switch_data);
     g_signal_handler_disconnect(switch_data->proxy, switch_data->handler);
     g_free(switch_data);
 }
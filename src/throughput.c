@@ -0,0 +1,218 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+/*
+ * Interface name -> ThroughputMeter
+ */
+static GHashTable *throughput_meters = NULL;
+static guint throughput_timeout_id = 0;
+
+static void throughput_meter_free(ThroughputMeter *meter) {
+    g_slist_free_full(meter->subscribers, g_free);
+    g_free(meter->interface);
+    g_free(meter);
+}
+
+static gboolean throughput_counter_read(const gchar *interface, const gchar *counter, guint64 *value) {
+    gchar *path, *contents;
+    gboolean success;
+
+    path = g_strdup_printf(THROUGHPUT_SYSFS_PATH, interface, counter);
+    success = g_file_get_contents(path, &contents, NULL, NULL);
+    g_free(path);
+
+    if (success) {
+	*value = g_ascii_strtoull(contents, NULL, 10);
+	g_free(contents);
+    }
+
+    return success;
+}
+
+/*
+ * The rate of a counter over the last interval. A counter which went backwards has
+ * been reset, e.g. because the interface was recreated.
+ */
+static gdouble throughput_rate(guint64 bytes_old, guint64 bytes_new, gdouble dt) {
+    if (bytes_new < bytes_old) {
+	return 0;
+    }
+
+    return (bytes_new - bytes_old) / dt;
+}
+
+static gboolean throughput_timeout() {
+    GHashTableIter iter;
+    ThroughputMeter *meter;
+
+    g_hash_table_iter_init(&iter, throughput_meters);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &meter)) {
+	if (throughput_sample(meter)) {
+	    for (GSList *i = meter->subscribers; i != NULL; i = i->next) {
+		ThroughputSubscriber *subscriber;
+
+		subscriber = i->data;
+		subscriber->callback(meter->rx_rate, meter->tx_rate, subscriber->user_data);
+	    }
+	}
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+/*
+ * A new subscriber immediately receives the current rates, if there are any. The
+ * counters are only read while at least one interface has subscribers.
+ */
+void throughput_subscribe(const gchar *interface, ThroughputCallback callback, gpointer user_data) {
+    ThroughputMeter *meter;
+    ThroughputSubscriber *subscriber;
+
+    if (throughput_meters == NULL) {
+	throughput_meters = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify) throughput_meter_free);
+    }
+
+    meter = g_hash_table_lookup(throughput_meters, interface);
+
+    if (meter == NULL) {
+	meter = g_malloc(sizeof(ThroughputMeter));
+	meter->interface = g_strdup(interface);
+	meter->time = 0;
+	meter->rx_rate = 0;
+	meter->tx_rate = 0;
+	meter->rates_valid = FALSE;
+	meter->subscribers = NULL;
+	g_hash_table_insert(throughput_meters, meter->interface, meter);
+
+	throughput_sample(meter);
+    }
+
+    subscriber = g_malloc(sizeof(ThroughputSubscriber));
+    subscriber->callback = callback;
+    subscriber->user_data = user_data;
+    meter->subscribers = g_slist_append(meter->subscribers, subscriber);
+
+    if (meter->rates_valid) {
+	callback(meter->rx_rate, meter->tx_rate, user_data);
+    }
+
+    if (throughput_timeout_id == 0) {
+	throughput_timeout_id = g_timeout_add_seconds(THROUGHPUT_INTERVAL, (GSourceFunc) throughput_timeout, NULL);
+    }
+}
+
+void throughput_unsubscribe(const gchar *interface, ThroughputCallback callback, gpointer user_data) {
+    ThroughputMeter *meter;
+
+    if (throughput_meters == NULL || (meter = g_hash_table_lookup(throughput_meters, interface)) == NULL) {
+	return;
+    }
+
+    for (GSList *i = meter->subscribers; i != NULL; i = i->next) {
+	ThroughputSubscriber *subscriber;
+
+	subscriber = i->data;
+
+	if (subscriber->callback == callback && subscriber->user_data == user_data) {
+	    meter->subscribers = g_slist_delete_link(meter->subscribers, i);
+	    g_free(subscriber);
+	    break;
+	}
+    }
+
+    if (meter->subscribers != NULL) {
+	return;
+    }
+
+    g_hash_table_remove(throughput_meters, interface);
+
+    if (g_hash_table_size(throughput_meters) == 0 && throughput_timeout_id != 0) {
+	g_source_remove(throughput_timeout_id);
+	throughput_timeout_id = 0;
+    }
+}
+
+/*
+ * Reads the interface's counters and folds the rates since the previous sample
+ * into the moving averages. The weight of the new sample grows with the time which
+ * has actually elapsed, so a delayed timeout doesn't skew the average.
+ * Returns TRUE if the rates were updated.
+ */
+gboolean throughput_sample(ThroughputMeter *meter) {
+    guint64 rx_bytes, tx_bytes;
+    gint64 time;
+    gboolean updated;
+
+    if (!throughput_counter_read(meter->interface, "rx_bytes", &rx_bytes) ||
+	!throughput_counter_read(meter->interface, "tx_bytes", &tx_bytes)) {
+	meter->time = 0;
+	return FALSE;
+    }
+
+    time = g_get_monotonic_time();
+    updated = FALSE;
+
+    if (meter->time != 0 && time > meter->time) {
+	gdouble dt, rx_rate, tx_rate;
+
+	dt = (time - meter->time) / (gdouble) G_USEC_PER_SEC;
+	rx_rate = throughput_rate(meter->rx_bytes, rx_bytes, dt);
+	tx_rate = throughput_rate(meter->tx_bytes, tx_bytes, dt);
+
+	if (meter->rates_valid) {
+	    gdouble alpha;
+
+	    alpha = dt / (dt + THROUGHPUT_TIME_CONSTANT);
+	    meter->rx_rate += alpha * (rx_rate - meter->rx_rate);
+	    meter->tx_rate += alpha * (tx_rate - meter->tx_rate);
+	}
+	else {
+	    meter->rx_rate = rx_rate;
+	    meter->tx_rate = tx_rate;
+	    meter->rates_valid = TRUE;
+	}
+
+	updated = TRUE;
+    }
+
+    meter->rx_bytes = rx_bytes;
+    meter->tx_bytes = tx_bytes;
+    meter->time = time;
+
+    return updated;
+}
+
+gchar* throughput_format(gdouble rx_rate, gdouble tx_rate) {
+    gchar *rx, *tx, *text;
+
+    rx = g_format_size((guint64) rx_rate);
+    tx = g_format_size((guint64) tx_rate);
+
+    /*
+     * Translators: The download and upload rates of a network interface, e.g.
+     * "↓ 1.2 MB/s ↑ 30.5 kB/s"
+     */
+    text = g_strdup_printf(_("↓ %s/s ↑ %s/s"), rx, tx);
+
+    g_free(rx);
+    g_free(tx);
+    return text;
+}
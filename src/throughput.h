@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_THROUGHPUT_H
+#define _IWGTK_THROUGHPUT_H
+
+#define THROUGHPUT_INTERVAL 2
+#define THROUGHPUT_TIME_CONSTANT 4.0
+#define THROUGHPUT_SYSFS_PATH "/sys/class/net/%s/statistics/%s"
+
+typedef struct ThroughputMeter_s ThroughputMeter;
+typedef struct ThroughputSubscriber_s ThroughputSubscriber;
+
+/*
+ * Rates are in bytes per second.
+ */
+typedef void (*ThroughputCallback) (gdouble rx_rate, gdouble tx_rate, gpointer user_data);
+
+/*
+ * The traffic counters of a network interface, sampled every THROUGHPUT_INTERVAL
+ * seconds for as long as it has subscribers. The rates are exponentially weighted
+ * moving averages with a time constant of THROUGHPUT_TIME_CONSTANT seconds.
+ */
+struct ThroughputMeter_s {
+    gchar *interface;
+    guint64 rx_bytes;
+    guint64 tx_bytes;
+    gint64 time;
+    gdouble rx_rate;
+    gdouble tx_rate;
+    gboolean rates_valid;
+    GSList *subscribers;
+};
+
+struct ThroughputSubscriber_s {
+    ThroughputCallback callback;
+    gpointer user_data;
+};
+
+void throughput_subscribe(const gchar *interface, ThroughputCallback callback, gpointer user_data);
+void throughput_unsubscribe(const gchar *interface, ThroughputCallback callback, gpointer user_data);
+gboolean throughput_sample(ThroughputMeter *meter);
+gchar* throughput_format(gdouble rx_rate, gdouble tx_rate);
+
+#endif
@@ -45,9 +45,19 @@ const gchar* get_error_detail(GError *err, const ErrorMessage *error_table) {
 }
 
 void method_call_notify(GDBusProxy *proxy, GAsyncResult *res, CallbackMessages *messages) {
+    method_call_notify_finish(proxy, res, messages, NULL);
+}
+
+/*
+ * Like method_call_notify(), but returns whether the call succeeded. On failure, the
+ * error is passed to the caller if error is non-NULL.
+ */
+gboolean method_call_notify_finish(GDBusProxy *proxy, GAsyncResult *res, CallbackMessages *messages, GError **error) {
     GVariant *ret;
     GError *err;
 
+    watchdog_mark("Method reply (%s)", g_dbus_proxy_get_interface_name(proxy));
+
     err = NULL;
     ret = g_dbus_proxy_call_finish(proxy, res, &err);
 
@@ -72,7 +82,13 @@ void method_call_notify(GDBusProxy *proxy, GAsyncResult *res, CallbackMessages *
 	}
 
 	g_printerr("%s\n", err->message);
-	g_error_free(err);
+
+	if (error != NULL) {
+	    *error = err;
+	}
+	else {
+	    g_error_free(err);
+	}
     }
 
     if (messages->free) {
@@ -80,12 +96,16 @@ void method_call_notify(GDBusProxy *proxy, GAsyncResult *res, CallbackMessages *
 	g_free((void *) messages->failure);
 	g_free((void *) messages);
     }
+
+    return ret != NULL;
 }
 
 void method_call_log(GDBusProxy *proxy, GAsyncResult *res, const gchar *message) {
     GVariant *ret;
     GError *err;
 
+    watchdog_mark("Method reply (%s)", g_dbus_proxy_get_interface_name(proxy));
+
     err = NULL;
     ret = g_dbus_proxy_call_finish(proxy, res, &err);
 
@@ -167,61 +187,6 @@ gboolean device_sort(GDBusProxy *proxy0, GDBusProxy *proxy1) {
     return FALSE;
 }
 
-void set_remote_property_callback(GDBusProxy *proxy, GAsyncResult *res, FailureClosure *failure) {
-    GVariant *ret;
-    GError *err;
-
-    err = NULL;
-    ret = g_dbus_proxy_call_finish(proxy, res, &err);
-
-    if (ret) {
-	g_variant_unref(ret);
-    }
-    else {
-	g_printerr("Failed to set remote property '%s': %s\n", failure->property, err->message);
-	g_error_free(err);
-
-	failure->callback(failure->data);
-    }
-
-    g_free(failure);
-}
-
-/*
- * When a property is updated remotely, iwgtk responds by updating a widget. This widget
- * state change triggers a signal which causes set_remote_property() to be called. The
- * equality check in this function prevents the property change from being volleyed back
- * to iwd. This is kind of a hack; it would be more elegant if set_remote_property() were
- * only called for user-initiated state changes.
- */
-void set_remote_property(GDBusProxy *proxy, const gchar *property, GVariant *value, SetFunction failure_callback, gpointer failure_data) {
-    GVariant *value_cached;
-
-    value_cached = g_dbus_proxy_get_cached_property(proxy, property);
-    if (!g_variant_equal(value, value_cached)) {
-	FailureClosure *failure_closure;
-
-	failure_closure = g_malloc(sizeof(FailureClosure));
-	failure_closure->callback = failure_callback;
-	failure_closure->data = failure_data;
-	failure_closure->property = property;
-
-	g_dbus_proxy_call(
-	    proxy,
-	    "org.freedesktop.DBus.Properties.Set",
-	    g_variant_new("(ssv)", g_dbus_proxy_get_interface_name(proxy), property, value),
-	    G_DBUS_CALL_FLAGS_NONE,
-	    -1,
-	    NULL,
-	    (GAsyncReadyCallback) set_remote_property_callback,
-	    failure_closure);
-    }
-    else {
-	g_variant_unref(value);
-    }
-    g_variant_unref(value_cached);
-}
-
 GVariant* lookup_property(GVariant *dictionary, const gchar *property) {
     GVariantIter iter;
     const gchar *key;
@@ -240,6 +205,40 @@ GVariant* lookup_property(GVariant *dictionary, const gchar *property) {
     return NULL;
 }
 
+/*
+ * Fetches a single property of an iwd object for which we hold no proxy.
+ */
+void remote_property_get(GDBusConnection *connection, const gchar *object_path, const gchar *interface, const gchar *property, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data) {
+    g_dbus_connection_call(
+	connection,
+	IWD_BUS_NAME,
+	object_path,
+	"org.freedesktop.DBus.Properties",
+	"Get",
+	g_variant_new("(ss)", interface, property),
+	G_VARIANT_TYPE("(v)"),
+	G_DBUS_CALL_FLAGS_NONE,
+	-1,
+	cancellable,
+	callback,
+	user_data);
+}
+
+GVariant* remote_property_get_finish(GDBusConnection *connection, GAsyncResult *res, GError **err) {
+    GVariant *ret, *value;
+
+    ret = g_dbus_connection_call_finish(connection, res, err);
+
+    if (ret == NULL) {
+	return NULL;
+    }
+
+    g_variant_get(ret, "(v)", &value);
+    g_variant_unref(ret);
+
+    return value;
+}
+
 void send_notification(const gchar *text) {
     if (~global.state & NOTIFICATIONS_DISABLE) {
 	GNotification *notification;
@@ -305,3 +304,61 @@ GtkWidget* new_label_gray(const gchar *text) {
     pango_attr_list_unref(attr_list);
     return label;
 }
+
+/*
+ * Append a field to a line of CSV, quoting it.
+ */
+void csv_field_append(GString *line, const gchar *field) {
+    g_string_append_c(line, '"');
+
+    for (const gchar *c = field; *c != '\0'; c ++) {
+	if (*c == '"') {
+	    g_string_append_c(line, '"');
+	}
+
+	g_string_append_c(line, *c);
+    }
+
+    g_string_append_c(line, '"');
+}
+
+void json_string_append(GString *json, const gchar *string) {
+    g_string_append_c(json, '"');
+
+    for (const guchar *c = (const guchar *) string; *c != '\0'; c ++) {
+	if (*c == '"' || *c == '\\') {
+	    g_string_append_c(json, '\\');
+	    g_string_append_c(json, *c);
+	}
+	else if (*c < 0x20) {
+	    g_string_append_printf(json, "\\u%04x", *c);
+	}
+	else {
+	    g_string_append_c(json, *c);
+	}
+    }
+
+    g_string_append_c(json, '"');
+}
+
+/*
+ * Format a time in microseconds since the epoch as ISO 8601 (UTC), with millisecond
+ * precision.
+ */
+gchar* timestamp_format(gint64 timestamp) {
+    GDateTime *datetime;
+    gchar *date, *formatted;
+
+    datetime = g_date_time_new_from_unix_utc(timestamp / G_USEC_PER_SEC);
+
+    if (datetime == NULL) {
+	return g_strdup("");
+    }
+
+    date = g_date_time_format(datetime, "%Y-%m-%dT%H:%M:%S");
+    formatted = g_strdup_printf("%s.%03dZ", date, (gint) (timestamp % G_USEC_PER_SEC / 1000));
+
+    g_free(date);
+    g_date_time_unref(datetime);
+    return formatted;
+}
@@ -22,29 +22,23 @@
 
 #define RGB_MAX 65535
 
-typedef void (*SetFunction) (gpointer data);
-
-typedef struct FailureClosure_s FailureClosure;
-
-struct FailureClosure_s {
-    SetFunction callback;
-    gpointer data;
-    const gchar *property;
-};
-
 const gchar* get_error_detail(GError *err, const ErrorMessage *error_table);
 void method_call_notify(GDBusProxy *proxy, GAsyncResult *res, CallbackMessages *data);
+gboolean method_call_notify_finish(GDBusProxy *proxy, GAsyncResult *res, CallbackMessages *data, GError **error);
 void method_call_log(GDBusProxy *proxy, GAsyncResult *res, const gchar *message);
 
 gboolean adapter_sort(GDBusProxy *proxy0, GDBusProxy *proxy1);
 gboolean device_sort(GDBusProxy *proxy0, GDBusProxy *proxy1);
-void set_remote_property_callback(GDBusProxy *proxy, GAsyncResult *res, FailureClosure *failure);
-void set_remote_property(GDBusProxy *proxy, const gchar *property, GVariant *value, SetFunction failure_callback, gpointer failure_data);
 GVariant* lookup_property(GVariant *dictionary, const gchar *property);
+void remote_property_get(GDBusConnection *connection, const gchar *object_path, const gchar *interface, const gchar *property, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data);
+GVariant* remote_property_get_finish(GDBusConnection *connection, GAsyncResult *res, GError **err);
 void send_notification(const gchar *text);
 void grid_column_set_alignment(GtkWidget *grid, int col, GtkAlign align);
 GtkWidget* label_with_spinner(const gchar *text);
 GtkWidget* new_label_bold(const gchar *text);
 GtkWidget* new_label_gray(const gchar *text);
+void csv_field_append(GString *line, const gchar *field);
+void json_string_append(GString *json, const gchar *string);
+gchar* timestamp_format(gint64 timestamp);
 
 #endif
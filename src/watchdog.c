@@ -0,0 +1,183 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+static Watchdog watchdog;
+
+static const gchar* watchdog_segment_label() {
+    return watchdog.segment_attributed ? watchdog.labels[(watchdog.n_labels - 1) % WATCHDOG_N_LABELS] : "unattributed";
+}
+
+static void watchdog_segment_end(gint64 now) {
+    gint64 duration;
+
+    duration = now - watchdog.segment_start;
+    histogram_add(&watchdog.segment, duration);
+
+    if (!watchdog.segment_attributed) {
+	watchdog.unattributed += duration;
+    }
+
+    if (duration >= watchdog.threshold) {
+	g_printerr("Watchdog: %s took %.1f ms\n", watchdog_segment_label(), duration / 1000.0);
+    }
+}
+
+static gint watchdog_poll(GPollFD *ufds, guint nfds, gint timeout) {
+    gint64 now;
+    gint ret;
+
+    now = g_get_monotonic_time();
+
+    if (watchdog.iteration_start != 0) {
+	gint64 duration;
+
+	watchdog_segment_end(now);
+
+	duration = now - watchdog.iteration_start;
+	histogram_add(&watchdog.iteration, duration);
+
+	if (duration >= watchdog.threshold) {
+	    GString *sources;
+
+	    sources = g_string_new(NULL);
+	    for (int i = MAX((gint) watchdog.n_labels - WATCHDOG_N_LABELS, 0); i < watchdog.n_labels; i ++) {
+		g_string_append_printf(sources, "%s%s", sources->len ? ", " : "", watchdog.labels[i % WATCHDOG_N_LABELS]);
+	    }
+
+	    if (watchdog.unattributed > 0) {
+		g_string_append_printf(sources, "%sunattributed %.1f ms", sources->len ? ", " : "", watchdog.unattributed / 1000.0);
+	    }
+
+	    g_printerr("Watchdog: Main loop was blocked for %.1f ms (%s)\n", duration / 1000.0, sources->str);
+	    g_string_free(sources, TRUE);
+
+	    watchdog.stalls ++;
+	}
+    }
+
+    ret = watchdog.poll_func(ufds, nfds, timeout);
+
+    watchdog.iteration_start = g_get_monotonic_time();
+    watchdog.segment_start = watchdog.iteration_start;
+    watchdog.n_labels = 0;
+
+    // Dispatches are unattributed until they're marked
+    watchdog.segment_attributed = FALSE;
+    watchdog.segment_source = NULL;
+    watchdog.unattributed = 0;
+
+    return ret;
+}
+
+/*
+ * A high priority timer which measures how late the main loop dispatches it.
+ */
+static gboolean watchdog_probe() {
+    gint64 now;
+
+    now = g_get_monotonic_time();
+    histogram_add(&watchdog.dispatch_latency, now - watchdog.probe_expected);
+    watchdog.probe_expected = now + WATCHDOG_PROBE_INTERVAL * 1000;
+
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean watchdog_properties_changed_hook(GSignalInvocationHint *hint, guint n_params, const GValue *params, gpointer data) {
+    GDBusProxy *proxy;
+
+    proxy = G_DBUS_PROXY(g_value_get_object(&params[0]));
+    watchdog_mark("PropertiesChanged(%s) %s", g_dbus_proxy_get_interface_name(proxy), g_dbus_proxy_get_object_path(proxy));
+
+    return TRUE;
+}
+
+void watchdog_init(gint threshold_ms) {
+    GMainContext *context;
+
+    if (watchdog.enabled) {
+	return;
+    }
+
+    watchdog.enabled = TRUE;
+    watchdog.threshold = (gint64) threshold_ms * 1000;
+
+    context = g_main_context_default();
+    watchdog.poll_func = g_main_context_get_poll_func(context);
+    g_main_context_set_poll_func(context, watchdog_poll);
+
+    watchdog.probe_expected = g_get_monotonic_time() + WATCHDOG_PROBE_INTERVAL * 1000;
+    g_timeout_add_full(G_PRIORITY_HIGH, WATCHDOG_PROBE_INTERVAL, (GSourceFunc) watchdog_probe, NULL, NULL);
+
+    g_type_class_unref(g_type_class_ref(G_TYPE_DBUS_PROXY));
+    g_signal_add_emission_hook(
+	g_signal_lookup("g-properties-changed", G_TYPE_DBUS_PROXY),
+	0,
+	watchdog_properties_changed_hook,
+	NULL,
+	NULL);
+}
+
+/*
+ * Start a new segment of the current main loop iteration. Calls from threads other
+ * than the main thread are ignored.
+ */
+void watchdog_mark(const gchar *format, ...) {
+    GSource *source;
+    gint64 now;
+    va_list args;
+
+    if (!watchdog.enabled || !g_main_context_is_owner(g_main_context_default())) {
+	return;
+    }
+
+    now = g_get_monotonic_time();
+    source = g_main_current_source();
+
+    if (watchdog.segment_start != 0) {
+	// The previous segment ran into an unmarked dispatch
+	if (watchdog.segment_source != source) {
+	    watchdog.segment_attributed = FALSE;
+	}
+
+	watchdog_segment_end(now);
+    }
+
+    watchdog.segment_start = now;
+    watchdog.segment_attributed = TRUE;
+    watchdog.segment_source = source;
+
+    va_start(args, format);
+    g_vsnprintf(watchdog.labels[watchdog.n_labels % WATCHDOG_N_LABELS], WATCHDOG_LABEL_LENGTH, format, args);
+    va_end(args);
+
+    watchdog.n_labels ++;
+}
+
+void watchdog_collect(GVariantBuilder *builder) {
+    if (!watchdog.enabled) {
+	return;
+    }
+
+    g_variant_builder_add(builder, "{sv}", "mainloop.stalls", g_variant_new_uint64(watchdog.stalls));
+    g_variant_builder_add(builder, "{sv}", "mainloop.dispatch-latency", histogram_to_variant(&watchdog.dispatch_latency));
+    g_variant_builder_add(builder, "{sv}", "mainloop.iteration", histogram_to_variant(&watchdog.iteration));
+    g_variant_builder_add(builder, "{sv}", "mainloop.callback", histogram_to_variant(&watchdog.segment));
+}
@@ -0,0 +1,64 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_WATCHDOG_H
+#define _IWGTK_WATCHDOG_H
+
+#define WATCHDOG_PROBE_INTERVAL 100
+#define WATCHDOG_N_LABELS 8
+#define WATCHDOG_LABEL_LENGTH 96
+
+typedef struct Watchdog_s Watchdog;
+
+/*
+ * Each iteration of the main loop is divided into segments. A segment begins
+ * whenever watchdog_mark() is called, and ends at the next mark or when the main
+ * loop goes back to polling. Its duration is attributed to the label passed to
+ * watchdog_mark(), as long as it doesn't extend into the dispatch of another source;
+ * otherwise, and before the first mark of an iteration, it's unattributed. A segment
+ * which ends when the main loop goes back to polling keeps its label, since the end
+ * of the last dispatch can't be observed.
+ */
+struct Watchdog_s {
+    gboolean enabled;
+    gint64 threshold;
+    GPollFunc poll_func;
+
+    gint64 iteration_start;
+    gint64 segment_start;
+    gint64 probe_expected;
+
+    gboolean segment_attributed;
+    GSource *segment_source;
+    gint64 unattributed;
+
+    guint n_labels;
+    gchar labels[WATCHDOG_N_LABELS][WATCHDOG_LABEL_LENGTH];
+
+    guint64 stalls;
+    Histogram dispatch_latency;
+    Histogram iteration;
+    Histogram segment;
+};
+
+void watchdog_init(gint threshold_ms);
+void watchdog_mark(const gchar *format, ...) G_GNUC_PRINTF(1, 2);
+void watchdog_collect(GVariantBuilder *builder);
+
+#endif
@@ -28,17 +28,19 @@ ObjectMethods object_methods[] = {
     {IWD_IFACE_AD_HOC,             (ConstructorFunction) adhoc_add,         (DestructorFunction) adhoc_remove},
     {IWD_IFACE_DPP,                (ConstructorFunction) dpp_add,           (DestructorFunction) dpp_remove},
     {IWD_IFACE_WPS,                (ConstructorFunction) wps_add,           (DestructorFunction) wps_remove},
-    {IWD_IFACE_STATION_DIAGNOSTIC, (ConstructorFunction) diagnostic_add,    (DestructorFunction) diagnostic_remove}
+    {IWD_IFACE_STATION_DIAGNOSTIC, (ConstructorFunction) diagnostic_add,    (DestructorFunction) diagnostic_remove},
+    {IWD_IFACE_AP_DIAGNOSTIC,      (ConstructorFunction) ap_diagnostic_add, (DestructorFunction) ap_diagnostic_remove}
 };
 
 CoupleMethods couple_methods[] = {
-    {(BindFunction) bind_adapter_device,    (UnbindFunction) unbind_adapter_device},
-    {(BindFunction) bind_device_station,    (UnbindFunction) unbind_device_station},
-    {(BindFunction) bind_device_ap,         (UnbindFunction) unbind_device_ap},
-    {(BindFunction) bind_device_adhoc,      (UnbindFunction) unbind_device_adhoc},
-    {(BindFunction) bind_station_dpp,       (UnbindFunction) unbind_station_dpp},
-    {(BindFunction) bind_station_wps,       (UnbindFunction) unbind_station_wps},
-    {(BindFunction) bind_device_diagnostic, (UnbindFunction) unbind_device_diagnostic}
+    {(BindFunction) bind_adapter_device,       (UnbindFunction) unbind_adapter_device},
+    {(BindFunction) bind_device_station,       (UnbindFunction) unbind_device_station},
+    {(BindFunction) bind_device_ap,            (UnbindFunction) unbind_device_ap},
+    {(BindFunction) bind_device_adhoc,         (UnbindFunction) unbind_device_adhoc},
+    {(BindFunction) bind_station_dpp,          (UnbindFunction) unbind_station_dpp},
+    {(BindFunction) bind_station_wps,          (UnbindFunction) unbind_station_wps},
+    {(BindFunction) bind_device_diagnostic,    (UnbindFunction) unbind_device_diagnostic},
+    {(BindFunction) bind_device_ap_diagnostic, (UnbindFunction) unbind_device_ap_diagnostic}
 };
 
 void window_launch() {
@@ -49,25 +51,49 @@ void window_launch() {
 	return;
     }
 
+    /*
+     * The full object manager only exists while there is a window; the indicators
+     * have their own, much lighter one.
+     */
     if (!global.manager) {
 	if (global.state & IWD_DOWN) {
 	    g_printerr("Cannot launch iwgtk window: iwd is not running\n");
 	}
-	else {
+	else if (~global.state & WINDOW_LAUNCH_PENDING) {
 	    global.state |= WINDOW_LAUNCH_PENDING;
 	    g_application_hold(G_APPLICATION(global.application));
+
+	    if (global.system_bus) {
+		object_manager_new(global.system_bus);
+	    }
+
+	    /*
+	     * Validate the icon theme while waiting for iwd, rather than after the
+	     * object manager has come back.
+	     */
+	    if (global.theme == NULL) {
+		g_idle_add_full(G_PRIORITY_LOW, (GSourceFunc) icon_theme_set_idle, NULL, NULL);
+	    }
 	}
 
 	return;
     }
 
+    /*
+     * The icon theme is only scanned once it's needed. The indicators draw their
+     * icons from the pre-rendered atlas where possible.
+     */
+    if (global.theme == NULL) {
+	icon_theme_set();
+    }
+
     window = g_malloc(sizeof(Window));
     global.window = window;
 
     memset(window->objects, 0, sizeof(void *) * n_object_types);
     memset(window->couples, 0, sizeof(void *) * n_couple_types);
 
-    window->window = gtk_application_window_new(global.application);
+    window->window = gtk_application_window_new(GTK_APPLICATION(global.application));
     gtk_window_set_title(GTK_WINDOW(window->window), PACKAGE);
     gtk_window_set_default_size(GTK_WINDOW(window->window), global.width, global.height);
     gtk_window_set_icon_name(GTK_WINDOW(window->window), PACKAGE);
@@ -133,6 +159,24 @@ void window_launch() {
     add_all_dbus_objects(window);
     g_signal_connect_swapped(window->window, "destroy", G_CALLBACK(window_rm), window);
     gtk_widget_set_visible(window->window, true);
+
+    if (global.launch_device_path) {
+	window_select_device(window, global.launch_device_path);
+	g_free(global.launch_device_path);
+	global.launch_device_path = NULL;
+    }
+}
+
+void window_select_device(Window *window, const gchar *device_path) {
+    for (ObjectList *list = window->objects[OBJECT_DEVICE]; list != NULL; list = list->next) {
+	if (strcmp(g_dbus_object_get_object_path(list->object), device_path) == 0) {
+	    Device *device;
+
+	    device = (Device *) list->data;
+	    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(device->button), TRUE);
+	    break;
+	}
+    }
 }
 
 void window_rm(Window *window) {
@@ -158,6 +202,12 @@ void window_rm(Window *window) {
 
     g_free(window);
     global.window = NULL;
+    survey_stop();
+
+    if (global.manager) {
+	g_object_unref(global.manager);
+	global.manager = NULL;
+    }
 }
 
 void known_network_table_show(GtkToggleButton *button, Window *window) {
@@ -166,10 +216,6 @@ void known_network_table_show(GtkToggleButton *button, Window *window) {
     }
 }
 
-/*
- * window=NULL implies that all interfaces are to be added to the indicator list, rather
- * than to a window.
- */
 void add_all_dbus_objects(Window *window) {
     GList *object_list, *i;
 
@@ -213,67 +259,12 @@ void interface_add(GDBusObjectManager *manager, GDBusObject *object, GDBusProxy
 
     for (int i = 0; i < n_object_types; i ++) {
 	if (strcmp(name, object_methods[i].interface) == 0) {
-	    if (window != NULL) {
-		// This function has been invoked for a particular window.
-		window_add_object(object, proxy, window, i);
+	    if (window == NULL) {
+		window = global.window;
 	    }
-	    else {
-		/*
-		 * If window=NULL and manager=NULL, then we are only interested in
-		 * initializing the indicators.
-		 */
-		if (manager != NULL && global.window != NULL) {
-		    window_add_object(object, proxy, global.window, i);
-		}
 
-		/*
-		 * There are two scenarios when we want to run this:
-		 * (1) due to a new object/interface being added (window=NULL, manager!=NULL)
-		 * (2) right after the manager is initialized (window=NULL, manager=NULL
-		 */
-		if (global.state & INDICATOR_DAEMON) {
-		    Indicator **indicator;
-
-		    indicator = &global.indicators;
-		    while (*indicator != NULL) {
-			GDBusObject *device_object;
-
-			device_object = g_dbus_interface_get_object(G_DBUS_INTERFACE((*indicator)->device_proxy));
-
-			if (object == device_object) {
-			    IndicatorSetter indicator_set_mode;
-
-			    indicator_set_mode = NULL;
-
-			    switch (i) {
-				case OBJECT_STATION:
-				    indicator_station_init_signal_agent(*indicator, proxy);
-				    indicator_set_mode = indicator_set_station;
-				    break;
-				case OBJECT_ACCESS_POINT:
-				    indicator_set_mode = indicator_set_ap;
-				    break;
-				case OBJECT_ADHOC:
-				    indicator_set_mode = indicator_set_adhoc;
-				    break;
-			    }
-
-			    if (indicator_set_mode != NULL) {
-				(*indicator)->proxy = proxy;
-				(*indicator)->update_mode_handler = g_signal_connect_swapped(proxy, "g-properties-changed", G_CALLBACK(indicator_set_mode), *indicator);
-				indicator_set_mode(*indicator);
-			    }
-
-			    return;
-			}
-
-			indicator = &(*indicator)->next;
-		    }
-
-		    if (i == OBJECT_DEVICE) {
-			*indicator = indicator_new(proxy);
-		    }
-		}
+	    if (window != NULL) {
+		window_add_object(object, proxy, window, i);
 	    }
 
 	    break;
@@ -325,40 +316,6 @@ void interface_rm(GDBusObjectManager *manager, GDBusObject *object, GDBusProxy *
 		}
 	    }
 
-	    if (global.state & INDICATOR_DAEMON) {
-		Indicator **indicator;
-
-		indicator = &global.indicators;
-
-		while (*indicator != NULL) {
-		    GDBusObject *device_object;
-
-		    device_object = g_dbus_interface_get_object(G_DBUS_INTERFACE((*indicator)->device_proxy));
-
-		    if (device_object == object) {
-			if (proxy == (*indicator)->device_proxy) {
-			    // The indicator's device has been taken down; delete the indicator
-
-			    Indicator *rm;
-
-			    rm = *indicator;
-			    *indicator = (*indicator)->next;
-			    indicator_rm(rm);
-			}
-			else if (proxy == (*indicator)->proxy) {
-			    // The indicator's mode has changed, or it has been powered down
-
-			    g_signal_handler_disconnect(proxy, (*indicator)->update_mode_handler);
-			    (*indicator)->update_mode_handler = 0;
-			}
-
-			return;
-		    }
-
-		    indicator = &(*indicator)->next;
-		}
-	    }
-
 	    break;
 	}
     }
@@ -20,7 +20,7 @@
 #ifndef _WINDOW_H
 #define _WINDOW_H
 
-#define n_object_types 9
+#define n_object_types 10
 typedef enum {
     OBJECT_KNOWN_NETWORK,
     OBJECT_ADAPTER,
@@ -30,10 +30,11 @@ typedef enum {
     OBJECT_ADHOC,
     OBJECT_DPP,
     OBJECT_WPS,
-    OBJECT_DIAGNOSTIC
+    OBJECT_DIAGNOSTIC,
+    OBJECT_AP_DIAGNOSTIC
 } ObjectType;
 
-#define n_couple_types 7
+#define n_couple_types 8
 typedef enum {
     ADAPTER_DEVICE,
     DEVICE_STATION,
@@ -41,7 +42,8 @@ typedef enum {
     DEVICE_ADHOC,
     STATION_DPP,
     STATION_WPS,
-    DEVICE_DIAGNOSTIC
+    DEVICE_DIAGNOSTIC,
+    DEVICE_AP_DIAGNOSTIC
 } CoupleType;
 
 typedef struct ObjectList_s ObjectList;
@@ -99,6 +101,7 @@ extern CoupleMethods couple_methods[];
 typedef void (*ObjectIterFunction) (GDBusObjectManager *manager, GDBusObject *object, GDBusProxy *proxy, Window *window);
 
 void window_launch();
+void window_select_device(Window *window, const gchar *device_path);
 void window_rm(Window *window);
 void known_network_table_show(GtkToggleButton *button, Window *window);
 
@@ -0,0 +1,110 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iwgtk.h"
+
+static Worker worker;
+
+static gpointer worker_thread(gpointer data) {
+    g_main_context_push_thread_default(worker.context);
+    g_main_loop_run(worker.loop);
+    g_main_context_pop_thread_default(worker.context);
+
+    return NULL;
+}
+
+/*
+ * Returns the worker's context, starting the worker thread if it isn't running yet.
+ */
+GMainContext* worker_context_get() {
+    if (worker.thread == NULL) {
+	worker.context = g_main_context_new();
+	worker.loop = g_main_loop_new(worker.context, FALSE);
+	worker.thread = g_thread_new("iwgtk-worker", worker_thread, NULL);
+    }
+
+    return worker.context;
+}
+
+static gboolean worker_register_object_cb(WorkerRegistration *reg) {
+    guint registration_id;
+    GError *err;
+
+    err = NULL;
+    registration_id = g_dbus_connection_register_object(
+	reg->connection,
+	reg->object_path,
+	reg->interface_info,
+	reg->vtable,
+	reg->user_data,
+	reg->user_data_free_func,
+	&err);
+
+    g_mutex_lock(&reg->mutex);
+    reg->registration_id = registration_id;
+    reg->err = err;
+    reg->done = TRUE;
+    g_cond_signal(&reg->cond);
+    g_mutex_unlock(&reg->mutex);
+
+    return G_SOURCE_REMOVE;
+}
+
+/*
+ * Equivalent to g_dbus_connection_register_object(), except that method calls are
+ * dispatched on the worker thread. Handlers must therefore not touch any GTK state;
+ * they should reply right away and use g_main_context_invoke() to pass any UI work
+ * to the main thread.
+ *
+ * Registration is performed on the worker thread, and this function blocks until it
+ * has completed.
+ */
+guint worker_register_object(GDBusConnection *connection, const gchar *object_path, GDBusInterfaceInfo *interface_info, const GDBusInterfaceVTable *vtable, gpointer user_data, GDestroyNotify user_data_free_func, GError **err) {
+    WorkerRegistration reg;
+
+    reg.connection = connection;
+    reg.object_path = object_path;
+    reg.interface_info = interface_info;
+    reg.vtable = vtable;
+    reg.user_data = user_data;
+    reg.user_data_free_func = user_data_free_func;
+    reg.registration_id = 0;
+    reg.err = NULL;
+    reg.done = FALSE;
+
+    g_mutex_init(&reg.mutex);
+    g_cond_init(&reg.cond);
+
+    g_main_context_invoke(worker_context_get(), (GSourceFunc) worker_register_object_cb, &reg);
+
+    g_mutex_lock(&reg.mutex);
+    while (!reg.done) {
+	g_cond_wait(&reg.cond, &reg.mutex);
+    }
+    g_mutex_unlock(&reg.mutex);
+
+    g_mutex_clear(&reg.mutex);
+    g_cond_clear(&reg.cond);
+
+    if (reg.err) {
+	g_propagate_error(err, reg.err);
+    }
+
+    return reg.registration_id;
+}
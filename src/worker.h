@@ -0,0 +1,55 @@
+/*
+ *  Copyright 2026 Jesse Lentz and contributors
+ *
+ *  This file is part of iwgtk.
+ *
+ *  iwgtk is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  iwgtk is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with iwgtk.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _IWGTK_WORKER_H
+#define _IWGTK_WORKER_H
+
+typedef struct Worker_s Worker;
+typedef struct WorkerRegistration_s WorkerRegistration;
+
+/*
+ * A thread with its own GMainContext, on which D-Bus objects that need to reply to
+ * iwd without waiting for the GTK main loop are exported.
+ */
+struct Worker_s {
+    GThread *thread;
+    GMainContext *context;
+    GMainLoop *loop;
+};
+
+struct WorkerRegistration_s {
+    GDBusConnection *connection;
+    const gchar *object_path;
+    GDBusInterfaceInfo *interface_info;
+    const GDBusInterfaceVTable *vtable;
+    gpointer user_data;
+    GDestroyNotify user_data_free_func;
+
+    guint registration_id;
+    GError *err;
+
+    GMutex mutex;
+    GCond cond;
+    gboolean done;
+};
+
+GMainContext* worker_context_get();
+guint worker_register_object(GDBusConnection *connection, const gchar *object_path, GDBusInterfaceInfo *interface_info, const GDBusInterfaceVTable *vtable, gpointer user_data, GDestroyNotify user_data_free_func, GError **err);
+
+#endif